@@ -0,0 +1,254 @@
+#pragma once
+
+#include "any_core.hpp"
+
+#include <cstdint>
+
+// static_any restricted to a closed list of types: the buffer is sized and aligned for the largest of _Ts, and the
+// stored type is a one byte index into _Ts instead of a vtable pointer, so that a static_closed_any<int, float> is
+// 8 bytes. Storing a type which is not one of _Ts does not build. As the index is the position in _Ts, it is the
+// same across shared libraries, and visit() is a single indirect call.
+template <class... _Ts>
+class static_closed_any
+{
+	static_assert(sizeof...(_Ts) > 0, "static_closed_any needs at least one type");
+	static_assert(sizeof...(_Ts) < 255, "static_closed_any holds up to 254 types");
+
+	template <class _T>
+	using index_of = detail::static_any::index_of<std::decay_t<_T>, _Ts...>;
+
+	template <class _T>
+	using enable_if_stored_t = std::enable_if_t<index_of<_T>::value != sizeof...(_Ts)>;
+
+public:
+	using size_type = std::size_t;
+	using index_type = std::uint8_t;
+
+	static constexpr index_type npos = 255;
+
+	static constexpr size_type capacity() { return detail::static_any::max_value(sizeof(_Ts)...); }
+
+	static constexpr size_type alignment() { return detail::static_any::max_value(alignof(_Ts)...); }
+
+	static_closed_any() = default;
+	~static_closed_any() { reset(); }
+
+	template <class _T, class = enable_if_stored_t<_T>>
+	static_closed_any(_T&& t) { emplace<std::decay_t<_T>>(std::forward<_T>(t)); }
+
+	static_closed_any(const static_closed_any& another);
+	static_closed_any(static_closed_any&& another);
+
+	// strong guarantee if the stored types are nothrow movable
+	template <class _T, class = enable_if_stored_t<_T>>
+	static_closed_any& operator=(_T&& t);
+
+	static_closed_any& operator=(const static_closed_any& another);
+	static_closed_any& operator=(static_closed_any&& another);
+
+	// basic guarantee: empty if the constructor of _T throws
+	template <class _T, class... Args>
+	void emplace(Args&&... args);
+
+	void reset();
+
+	bool empty() const { return __index == npos; }
+
+	// position of the stored type in _Ts, npos if empty
+	index_type index() const { return __index; }
+
+	template <class _T>
+	bool has() const { return __index == index_of<_T>::value; }
+
+	template <class _T>
+	_T& get();
+
+	template <class _T>
+	const _T& get() const;
+
+	template <class _T>
+	_T* try_get() { return has<_T>() ? reinterpret_cast<_T*>(__buff.data()) : nullptr; }
+
+	template <class _T>
+	const _T* try_get() const { return has<_T>() ? reinterpret_cast<const _T*>(__buff.data()) : nullptr; }
+
+	const static_any_type_info& type() const { return empty() ? static_any_typeid<void>() : *vtable_at(__index)->type_info; }
+
+	static_any_type_id_t type_id() const;
+
+	// calls visitor with the stored value, returns false if empty
+	template <class _Visitor>
+	bool visit(_Visitor&& visitor);
+
+	template <class _Visitor>
+	bool visit(_Visitor&& visitor) const;
+
+private:
+	using vtable = detail::static_any::vtable;
+	using visit_table = detail::static_any::visit_table<_Ts...>;
+
+	// constant initialized, unlike a local static which is guarded on every call
+	static constexpr const vtable* const vtables[] = { &detail::static_any::vtable_for<std::remove_cv_t<_Ts>>::value... };
+
+	static const vtable* vtable_at(index_type index) { return vtables[index]; }
+
+	std::size_t visit_index() const { return empty() ? visit_table::npos : __index; }
+
+	void copy_from(const static_closed_any& another);
+	void move_from(static_closed_any& another);
+
+	alignas(detail::static_any::max_value(alignof(_Ts)...)) std::array<char, detail::static_any::max_value(sizeof(_Ts)...)> __buff;
+	index_type __index = npos;
+};
+
+template <class... _Ts>
+constexpr typename static_closed_any<_Ts...>::index_type static_closed_any<_Ts...>::npos;
+
+template <class... _Ts>
+constexpr const typename static_closed_any<_Ts...>::vtable* const static_closed_any<_Ts...>::vtables[];
+
+template <class... _Ts>
+static_closed_any<_Ts...>::static_closed_any(const static_closed_any& another)
+{
+	copy_from(another);
+}
+
+template <class... _Ts>
+static_closed_any<_Ts...>::static_closed_any(static_closed_any&& another)
+{
+	move_from(another);
+}
+
+template <class... _Ts>
+template <class _T, class>
+static_closed_any<_Ts...>& static_closed_any<_Ts...>::operator=(_T&& t)
+{
+	if (std::is_nothrow_constructible<std::decay_t<_T>, _T&&>::value)
+		emplace<std::decay_t<_T>>(std::forward<_T>(t));
+	else
+		*this = static_closed_any(std::forward<_T>(t));
+	return *this;
+}
+
+template <class... _Ts>
+static_closed_any<_Ts...>& static_closed_any<_Ts...>::operator=(const static_closed_any& another)
+{
+	if (this == &another)
+		return *this;
+
+	if (another.empty() || vtable_at(another.__index)->nothrow_copy)
+	{
+		reset();
+		copy_from(another);
+	}
+	else
+	{
+		// the copy may throw: made aside first
+		*this = static_closed_any(another);
+	}
+	return *this;
+}
+
+template <class... _Ts>
+static_closed_any<_Ts...>& static_closed_any<_Ts...>::operator=(static_closed_any&& another)
+{
+	if (this == &another)
+		return *this;
+
+	reset();
+	move_from(another);
+	return *this;
+}
+
+template <class... _Ts>
+template <class _T, class... Args>
+void static_closed_any<_Ts...>::emplace(Args&&... args)
+{
+	static_assert(index_of<_T>::value != sizeof...(_Ts), "_T is not one of the types of static_closed_any");
+
+	reset();
+	new(__buff.data()) _T(std::forward<Args>(args)...);
+	__index = static_cast<index_type>(index_of<_T>::value);
+}
+
+template <class... _Ts>
+void static_closed_any<_Ts...>::reset()
+{
+	if (empty())
+		return;
+
+	detail::static_any::destroy_n(vtable_at(__index), __buff.data(), 1, capacity());
+	__index = npos;
+}
+
+template <class... _Ts>
+template <class _T>
+_T& static_closed_any<_Ts...>::get()
+{
+	if (!has<_T>())
+		throw bad_any_cast(type(), static_any_typeid<_T>());
+
+	return *reinterpret_cast<_T*>(__buff.data());
+}
+
+template <class... _Ts>
+template <class _T>
+const _T& static_closed_any<_Ts...>::get() const
+{
+	return const_cast<static_closed_any*>(this)->template get<const _T>();
+}
+
+template <class... _Ts>
+static_any_type_id_t static_closed_any<_Ts...>::type_id() const
+{
+	static constexpr static_any_type_id_t type_ids[] = { static_any_type_id<_Ts>::value... };
+	return empty() ? static_any_type_id<void>::value : type_ids[__index];
+}
+
+template <class... _Ts>
+void static_closed_any<_Ts...>::copy_from(const static_closed_any& another)
+{
+	assert(empty());
+	if (another.empty())
+		return;
+
+	detail::static_any::copy_n(vtable_at(another.__index), __buff.data(), another.__buff.data(), 1, capacity());
+	__index = another.__index;
+}
+
+template <class... _Ts>
+void static_closed_any<_Ts...>::move_from(static_closed_any& another)
+{
+	assert(empty());
+	if (another.empty())
+		return;
+
+	detail::static_any::move_n(vtable_at(another.__index), __buff.data(), another.__buff.data(), 1, capacity());
+	__index = another.__index;
+}
+
+template <class... _Ts>
+template <class _Visitor>
+bool static_closed_any<_Ts...>::visit(_Visitor&& visitor)
+{
+	return visit_table::call(visit_index(), static_cast<void*>(__buff.data()), visitor);
+}
+
+template <class... _Ts>
+template <class _Visitor>
+bool static_closed_any<_Ts...>::visit(_Visitor&& visitor) const
+{
+	return visit_table::call(visit_index(), static_cast<const void*>(__buff.data()), visitor);
+}
+
+template <class... _Ts, class _Visitor>
+inline bool visit(static_closed_any<_Ts...>& a, _Visitor&& visitor)
+{
+	return a.visit(std::forward<_Visitor>(visitor));
+}
+
+template <class... _Ts, class _Visitor>
+inline bool visit(const static_closed_any<_Ts...>& a, _Visitor&& visitor)
+{
+	return a.visit(std::forward<_Visitor>(visitor));
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "any_core.hpp"
+
+#include <string>
+
+// Like any specialization, the opt-in has to be visible wherever strings are stored in a static_any: include this
+// header, or any.hpp, rather than any_core.hpp alone.
+template <class _Char, class _Traits, class _Alloc>
+struct static_any_comparable<std::basic_string<_Char, _Traits, _Alloc>> : public std::true_type {};
+
+// Two static_any are equal if both are empty, or if they hold values of the same type comparing equal. Throws
+// bad_any_operation if the type has no operator==.
+template <std::size_t _S1, std::size_t _A1, std::size_t _S2, std::size_t _A2>
+inline bool operator==(const static_any<_S1, _A1>& a, const static_any<_S2, _A2>& b)
+{
+	if (!detail::static_any::is_same_type(a.__vtable, b.__vtable))
+		return false;
+
+	return a.__vtable == nullptr || a.__vtable->equals(a.__buff.data(), b.__buff.data());
+}
+
+template <std::size_t _S1, std::size_t _A1, std::size_t _S2, std::size_t _A2>
+inline bool operator!=(const static_any<_S1, _A1>& a, const static_any<_S2, _A2>& b)
+{
+	return !(a == b);
+}
+
+// Orders the static_any by type first -- the empty ones first --, then by value. Throws bad_any_operation if
+// the type has no operator<.
+template <std::size_t _S1, std::size_t _A1, std::size_t _S2, std::size_t _A2>
+inline bool operator<(const static_any<_S1, _A1>& a, const static_any<_S2, _A2>& b)
+{
+	if (!detail::static_any::is_same_type(a.__vtable, b.__vtable))
+		return detail::static_any::is_type_before(a.__vtable, b.__vtable);
+
+	return a.__vtable != nullptr && a.__vtable->less(a.__buff.data(), b.__buff.data());
+}
+
+template <std::size_t _S1, std::size_t _A1, std::size_t _S2, std::size_t _A2>
+inline bool operator>(const static_any<_S1, _A1>& a, const static_any<_S2, _A2>& b)
+{
+	return b < a;
+}
+
+template <std::size_t _S1, std::size_t _A1, std::size_t _S2, std::size_t _A2>
+inline bool operator<=(const static_any<_S1, _A1>& a, const static_any<_S2, _A2>& b)
+{
+	return !(b < a);
+}
+
+template <std::size_t _S1, std::size_t _A1, std::size_t _S2, std::size_t _A2>
+inline bool operator>=(const static_any<_S1, _A1>& a, const static_any<_S2, _A2>& b)
+{
+	return !(a < b);
+}
+
+namespace std {
+
+template <std::size_t _N, std::size_t _Align>
+struct hash<static_any<_N, _Align>>
+{
+	std::size_t operator()(const static_any<_N, _Align>& a) const { return a.hash(); }
+};
+
+}
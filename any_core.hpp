@@ -0,0 +1,2083 @@
+#pragma once
+
+// Core of the library: static_any, static_unique_any, static_any_t and the casts. The comparisons, the range
+// algorithms and small_any are in any_compare.hpp, any_range.hpp and any_small.hpp, all included by any.hpp.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <new>
+#include <type_traits>
+#include <typeinfo>
+#include <cassert>
+#include <functional>
+#include <utility>
+
+#if defined(_MSC_VER)
+# define STATIC_ANY_PRETTY_FUNCTION __FUNCSIG__
+#else
+# define STATIC_ANY_PRETTY_FUNCTION __PRETTY_FUNCTION__
+#endif
+
+#if defined(_MSVC_LANG)
+# define STATIC_ANY_CPLUSPLUS _MSVC_LANG
+#else
+# define STATIC_ANY_CPLUSPLUS __cplusplus
+#endif
+
+// static_any_t can be built in constant expressions -- and so constant-initialized -- with std::bit_cast
+#if STATIC_ANY_CPLUSPLUS >= 202002L
+# include <bit>
+# if defined(__cpp_lib_bit_cast) && defined(__cpp_lib_is_constant_evaluated)
+#  define STATIC_ANY_HAS_CONSTEXPR_T
+#  define STATIC_ANY_CONSTEXPR_T constexpr
+# endif
+#endif
+
+#if !defined(STATIC_ANY_CONSTEXPR_T)
+# define STATIC_ANY_CONSTEXPR_T
+#endif
+
+// With STATIC_ANY_INSTRUMENTATION defined, the operations of static_any are counted per stored type, and reported
+// by static_any_for_each_stats and static_any_dump_stats. It changes the layout of the vtables: it has to be
+// defined, or not, for the whole program.
+#if defined(STATIC_ANY_INSTRUMENTATION)
+# include <atomic>
+# include <cstdio>
+# define STATIC_ANY_COUNT_N(vt, counter, n) ::detail::static_any::count_operation((vt), &::detail::static_any::type_stats::counter, (n))
+#else
+# define STATIC_ANY_COUNT_N(vt, counter, n) static_cast<void>(0)
+#endif
+
+#define STATIC_ANY_COUNT(vt, counter) STATIC_ANY_COUNT_N(vt, counter, 1)
+
+// Without RTTI -- detected, or forced by defining STATIC_ANY_NO_RTTI --, type() returns a static_any_type_info
+// holding the name of the type parsed from a function signature, and the types are compared by type_id as with
+// STATIC_ANY_USE_TYPE_ID.
+#if !defined(STATIC_ANY_NO_RTTI)
+# if (defined(__GNUC__) && !defined(__GXX_RTTI)) || (defined(_MSC_VER) && !defined(_CPPRTTI))
+#  define STATIC_ANY_NO_RTTI
+# endif
+#endif
+
+#if defined(STATIC_ANY_NO_RTTI) && !defined(STATIC_ANY_USE_TYPE_ID)
+# define STATIC_ANY_USE_TYPE_ID
+#endif
+
+using static_any_type_id_t = std::uint64_t;
+
+#if defined(STATIC_ANY_NO_RTTI)
+
+// Replacement of std::type_info without RTTI: two types are the same if they have the same static_any_type_id,
+// in every shared library. The name is readable, "std::pair<int, double>" for instance, and is parsed the first
+// time it is asked for: an instance is a constant, which the vtables point to.
+class static_any_type_info
+{
+public:
+	constexpr static_any_type_info(static_any_type_id_t id, const char* (*type_name)()) :
+		__id(id),
+		__name(type_name)
+	{}
+
+	static_any_type_info(const static_any_type_info&) = delete;
+	static_any_type_info& operator=(const static_any_type_info&) = delete;
+
+	const char* name() const noexcept { return __name(); }
+
+	static_any_type_id_t id() const noexcept { return __id; }
+
+	std::size_t hash_code() const noexcept { return static_cast<std::size_t>(__id); }
+
+	bool before(const static_any_type_info& other) const noexcept { return __id < other.__id; }
+
+	bool operator==(const static_any_type_info& other) const noexcept { return __id == other.__id; }
+	bool operator!=(const static_any_type_info& other) const noexcept { return __id != other.__id; }
+
+private:
+	static_any_type_id_t __id;
+	const char* (*__name)();
+};
+
+#else
+
+using static_any_type_info = std::type_info;
+
+#endif
+
+namespace detail { namespace static_any {
+
+struct move_tag {};
+struct copy_tag {};
+
+struct type_stats;
+
+// One table per stored type. A null copy, move or destroy entry means the operation is trivial:
+// the value is copied/moved with a fixed-size memcpy of the source buffer, and there is nothing
+// to do on destruction. Copying a type which is not copy constructible throws bad_any_copy.
+//
+// The _n variants apply the operation on count values separated by stride bytes, with a single
+// indirect call. If a copy or a move throws, the values already constructed are destroyed.
+//
+// hash, equals and less use std::hash, operator== and operator< of the stored type, and throw
+// bad_any_operation if the type does not opt in with static_any_comparable, or does not support them.
+struct vtable
+{
+	const static_any_type_info* type_info;
+	static_any_type_id_t type_id;
+	// false if another type may have the same type_id, which then does not identify the type
+	bool unique_type_id;
+	std::size_t size;
+	std::size_t align;
+	bool copyable;
+	bool nothrow_copy;
+	bool nothrow_move;
+	void (*copy)(void* this_ptr, const void* other_ptr);
+	void (*move)(void* this_ptr, void* other_ptr);
+	void (*destroy)(void* this_ptr);
+	void (*copy_n)(void* this_ptr, const void* other_ptr, std::size_t count, std::size_t stride);
+	void (*move_n)(void* this_ptr, void* other_ptr, std::size_t count, std::size_t stride);
+	void (*destroy_n)(void* this_ptr, std::size_t count, std::size_t stride);
+	std::size_t (*hash)(const void* this_ptr);
+	bool (*equals)(const void* this_ptr, const void* other_ptr);
+	bool (*less)(const void* this_ptr, const void* other_ptr);
+#if defined(STATIC_ANY_INSTRUMENTATION)
+	type_stats* stats;
+#endif
+};
+
+constexpr std::size_t max_alignment(std::size_t a, std::size_t b) { return a < b ? b : a; }
+
+// static_any's buffer is followed by the vtable pointer: by default, align it as the pointer to keep
+// the 8 bytes overhead, while still being able to store 64 bits scalars on 32 bits platforms
+constexpr std::size_t default_alignment = max_alignment(alignof(const vtable*), max_alignment(alignof(double), alignof(long long)));
+
+constexpr std::size_t max_value(std::size_t value)
+{
+	return value;
+}
+
+template <class... _Sizes>
+constexpr std::size_t max_value(std::size_t first, std::size_t second, _Sizes... others)
+{
+	return max_value(first < second ? second : first, others...);
+}
+
+// the largest power of two dividing the size, up to the fundamental alignment: aligning a buffer on
+// it never adds padding
+constexpr std::size_t natural_alignment(std::size_t size)
+{
+	std::size_t align = 1;
+	while (align < alignof(std::max_align_t) && size % (align * 2) == 0)
+		align *= 2;
+	return align;
+}
+
+// natural alignment of a buffer followed by a type id
+constexpr std::size_t tagged_alignment(std::size_t size)
+{
+	return natural_alignment(size) < natural_alignment(size + sizeof(static_any_type_id_t)) ?
+		natural_alignment(size) : natural_alignment(size + sizeof(static_any_type_id_t));
+}
+
+// 64 bits FNV-1a
+constexpr static_any_type_id_t hash(const char* str)
+{
+	static_any_type_id_t h = 14695981039346656037ull;
+	while (*str)
+	{
+		h ^= static_cast<unsigned char>(*str++);
+		h *= 1099511628211ull;
+	}
+	return h;
+}
+
+// the signature of the function contains the name of _T: it is the same in every shared library
+// built with the same compiler
+template <class _T>
+constexpr static_any_type_id_t type_name_hash()
+{
+	return hash(STATIC_ANY_PRETTY_FUNCTION);
+}
+
+template <class _T>
+struct hashed_type_id : public std::integral_constant<static_any_type_id_t, type_name_hash<_T>()> {};
+
+constexpr bool contains(const char* str, const char* part)
+{
+	for (; *str; ++str)
+	{
+		std::size_t i = 0;
+		while (part[i] && str[i] == part[i])
+			++i;
+		if (!part[i])
+			return true;
+	}
+	return false;
+}
+
+// Lambdas, local classes, unnamed types and types of anonymous namespaces -- or templates of them -- may share
+// their name with another type: gcc names two lambdas of the same function "f()::<lambda()>", and two translation
+// units may declare the same name in their anonymous namespaces.
+//   gcc:   "<lambda", "{anonymous}", "<unnamed", "f()::Local"
+//   clang: "(lambda at", "(anonymous namespace)", "(unnamed", "f()::Local"
+//   msvc:  "<lambda_", "`anonymous namespace'", "`f'::`2'::Local"
+constexpr bool is_unique_name(const char* signature)
+{
+	return !contains(signature, "<lambda") &&
+		!contains(signature, "(lambda") &&
+		!contains(signature, "{anonymous}") &&
+		!contains(signature, "anonymous namespace") &&
+		!contains(signature, "<unnamed") &&
+		!contains(signature, "(unnamed") &&
+		!contains(signature, ")::") &&
+		!contains(signature, " const::") &&
+		!contains(signature, "`");
+}
+
+template <class _T>
+constexpr bool type_name_is_unique()
+{
+	return is_unique_name(STATIC_ANY_PRETTY_FUNCTION);
+}
+
+#if defined(STATIC_ANY_NO_RTTI)
+
+// Copies the name of the type out of the signature of type_name<_T>():
+//   gcc:   "const char* detail::static_any::type_name() [with _T = int]"
+//   clang: "const char *detail::static_any::type_name() [_T = int]"
+//   msvc:  "const char *__cdecl detail::static_any::type_name<int>(void)"
+// The whole signature is kept if it has another format.
+inline void copy_type_name(const char* signature, char* name)
+{
+	const char* begin = std::strstr(signature, "_T = ");
+	const char* end = nullptr;
+
+	if (begin != nullptr)
+	{
+		begin += std::strlen("_T = ");
+		end = std::strrchr(begin, ']');
+	}
+	else if ((begin = std::strstr(signature, "type_name<")) != nullptr)
+	{
+		begin += std::strlen("type_name<");
+		end = std::strrchr(begin, '>');
+	}
+
+	if (begin == nullptr || end == nullptr)
+	{
+		begin = signature;
+		end = signature + std::strlen(signature);
+	}
+
+	const std::size_t size = static_cast<std::size_t>(end - begin);
+	std::memcpy(name, begin, size);
+	name[size] = '\0';
+}
+
+template <std::size_t _Size>
+struct type_name_buffer
+{
+	explicit type_name_buffer(const char* signature) { copy_type_name(signature, data); }
+
+	char data[_Size];
+};
+
+template <class _T>
+inline const char* type_name()
+{
+	static const type_name_buffer<sizeof(STATIC_ANY_PRETTY_FUNCTION)> name(STATIC_ANY_PRETTY_FUNCTION);
+	return name.data;
+}
+
+#endif
+
+inline static_any_type_id_t hash_bytes(const void* data, std::size_t size)
+{
+	const unsigned char* bytes = static_cast<const unsigned char*>(data);
+
+	static_any_type_id_t h = 14695981039346656037ull;
+	for (std::size_t i = 0; i < size; ++i)
+	{
+		h ^= bytes[i];
+		h *= 1099511628211ull;
+	}
+	return h;
+}
+
+inline std::size_t hash_combine(std::size_t seed, std::size_t h)
+{
+	return seed ^ (h + 0x9e3779b9 + (seed << 6) + (seed >> 2));
+}
+
+template <class...>
+struct make_void { using type = void; };
+
+template <class... _Ts>
+using void_t = typename make_void<_Ts...>::type;
+
+template <class _T, class = void>
+struct is_hashable : public std::false_type {};
+
+template <class _T>
+struct is_hashable<_T, void_t<decltype(std::hash<_T>{}(std::declval<const _T&>()))>> : public std::true_type {};
+
+template <class _T, class = void>
+struct is_equality_comparable : public std::false_type {};
+
+template <class _T>
+struct is_equality_comparable<_T, void_t<decltype(static_cast<bool>(std::declval<const _T&>() == std::declval<const _T&>()))>> : public std::true_type {};
+
+template <class _T, class = void>
+struct is_less_comparable : public std::false_type {};
+
+template <class _T>
+struct is_less_comparable<_T, void_t<decltype(static_cast<bool>(std::declval<const _T&>() < std::declval<const _T&>()))>> : public std::true_type {};
+
+}}
+
+// Identifier of a stored type, returned by static_any::type_id(). By default, it is a hash of the name
+// of the type. It can be registered explicitly with a specialization:
+//
+//   template <> struct static_any_type_id<message> : std::integral_constant<static_any_type_id_t, 42> {};
+//
+// Registered types are compared by id across shared libraries, instead of comparing their std::type_info. When
+// STATIC_ANY_USE_TYPE_ID is defined, the same is done for all types: two types of same name -- both
+// declared in an anonymous namespace for instance -- are then considered the same.
+template <class _T>
+struct static_any_type_id : public detail::static_any::hashed_type_id<_T> {};
+
+namespace detail { namespace static_any {
+
+// address of typeid(_T), or of its replacement without RTTI: a constant, stored in the vtables
+template <class _T>
+struct type_info_for
+{
+#if defined(STATIC_ANY_NO_RTTI)
+	static constexpr ::static_any_type_info info{::static_any_type_id<_T>::value, &type_name<_T>};
+	static constexpr const ::static_any_type_info* value = &info;
+#else
+	static constexpr const ::static_any_type_info* value = &typeid(_T);
+#endif
+};
+
+#if defined(STATIC_ANY_NO_RTTI)
+template <class _T>
+constexpr ::static_any_type_info type_info_for<_T>::info;
+#endif
+
+template <class _T>
+constexpr const ::static_any_type_info* type_info_for<_T>::value;
+
+}}
+
+// typeid(_T), or its replacement without RTTI
+template <class _T>
+inline const static_any_type_info& static_any_typeid()
+{
+	return *detail::static_any::type_info_for<std::remove_cv_t<_T>>::value;
+}
+
+// Opt-in of a stored type in the hash and the comparisons of static_any: std::hash, operator== and operator< of
+// the types opting in are used when they are declared, the other types throw bad_any_operation. Nothing is
+// instantiated for the types which do not opt in, as operators may be declared without being instantiable -- those
+// of std::vector of a non comparable type for instance. The scalar types opt in, and std::basic_string does in
+// any_compare.hpp, so that this header does not depend on <string>; other types opt in with a specialization,
+// declared with the type as for static_any_type_id:
+//
+//   template <> struct static_any_comparable<order_id> : std::true_type {};
+template <class _T>
+struct static_any_comparable :
+	public std::integral_constant<bool, std::is_arithmetic<_T>::value || std::is_enum<_T>::value || std::is_pointer<_T>::value>
+{};
+
+namespace detail { namespace static_any {
+
+template <bool _OptIn, class _Detected>
+struct opted_in_if : public std::false_type {};
+
+template <class _Detected>
+struct opted_in_if<true, _Detected> : public _Detected {};
+
+// _Detected, the detection of an operator of _T, only instantiated if _T opts in
+template <class _T, class _Detected>
+struct opted_in : public opted_in_if<::static_any_comparable<_T>::value, _Detected> {};
+
+}}
+
+// Tag selecting the in place constructors, which construct a _T from the arguments directly in the buffer.
+// It is std::in_place_type_t from C++17 on.
+#if STATIC_ANY_CPLUSPLUS >= 201703L
+template <class _T>
+using static_any_in_place_type_t = std::in_place_type_t<_T>;
+#else
+template <class _T>
+struct static_any_in_place_type_t
+{
+	explicit static_any_in_place_type_t() = default;
+};
+#endif
+
+template <class _T>
+constexpr static_any_in_place_type_t<_T> static_any_in_place_type{};
+
+// Exception guarantees of static_any::emplace and static_any::assign, given as first argument. Whatever
+// the guarantee, a _T constructible without throwing is constructed in place right away.
+//
+//  - basic: the current value is destroyed first, the static_any is left empty if the constructor throws
+//  - strong: the current value is backed up to a temporary static_any, and restored if the constructor throws
+//  - double buffer: the _T is constructed in a temporary buffer of sizeof(_T) and moved in place. Used for
+//    the nothrow movable types up to _MaxSize bytes; strong guarantee through backup for the others
+struct static_any_basic_guarantee_t {};
+struct static_any_strong_guarantee_t {};
+
+template <std::size_t _MaxSize = 64>
+struct static_any_double_buffer_guarantee_t {};
+
+constexpr static_any_basic_guarantee_t static_any_basic_guarantee{};
+constexpr static_any_strong_guarantee_t static_any_strong_guarantee{};
+constexpr static_any_double_buffer_guarantee_t<> static_any_double_buffer_guarantee{};
+
+class bad_any_copy : public std::exception
+{
+public:
+	explicit bad_any_copy(const static_any_type_info& type) :
+		__type(type)
+	{}
+
+	const static_any_type_info& stored_type() const { return __type; }
+
+	const char* what() const noexcept override
+	{
+		return "failed copy of static_any: stored type is not copy constructible";
+	}
+
+private:
+	const static_any_type_info& __type;
+};
+
+class bad_any_operation : public std::exception
+{
+public:
+	explicit bad_any_operation(const static_any_type_info& type) :
+		__type(type)
+	{}
+
+	const static_any_type_info& stored_type() const { return __type; }
+
+	const char* what() const noexcept override
+	{
+		return "failed hash or comparison of static_any: not supported by the stored type";
+	}
+
+private:
+	const static_any_type_info& __type;
+};
+
+template <std::size_t _N, std::size_t _Align = detail::static_any::default_alignment>
+class static_any;
+
+template <std::size_t _N, std::size_t _Align = detail::static_any::default_alignment>
+class static_unique_any;
+
+// defined in any_vector.hpp
+template <std::size_t _N, std::size_t _Align, class _Alloc>
+class static_any_vector;
+
+template <std::size_t _N, std::size_t _Align>
+class static_any
+{
+	static_assert(_Align != 0 && (_Align & (_Align - 1)) == 0, "_Align has to be a power of two");
+
+public:
+	template <typename _T>
+	struct is_static_any : public std::false_type {};
+
+	template <std::size_t _M, std::size_t _AlignM>
+	struct is_static_any<static_any<_M, _AlignM>> : public std::true_type {};
+
+	template <std::size_t _M, std::size_t _AlignM>
+	struct is_static_any<static_unique_any<_M, _AlignM>> : public std::true_type {};
+
+	template <class _T>
+	static constexpr bool is_static_any_v = is_static_any<_T>::value;
+
+	using size_type = std::size_t;
+
+	static_any();
+	~static_any();
+
+	template <class _T,
+			  class = std::enable_if_t<!is_static_any_v<std::decay_t<_T>>>>
+	static_any(_T&&);
+
+	static_any(const static_any&);
+
+	// not a template, so that the move of the temporary in static_any a = value; can be elided
+	static_any(static_any&&);
+
+	// constructs a _T from args in place, without a temporary to move from
+	template <class _T, class... Args>
+	explicit static_any(static_any_in_place_type_t<_T>, Args&&... args);
+
+	template <std::size_t _M, std::size_t _AlignM, class = std::enable_if_t<_M <= _N && _AlignM <= _Align>>
+	static_any(const static_any<_M, _AlignM>&);
+
+	template <std::size_t _M, std::size_t _AlignM, class = std::enable_if_t<_M <= _N && _AlignM <= _Align>>
+	static_any(static_any<_M, _AlignM>&&);
+
+	template <class _T,
+			  class = std::enable_if_t<!is_static_any_v<std::decay_t<_T>>>>
+	static_any& operator=(_T&& t);
+
+	static_any& operator=(const static_any& any)
+	{
+		assign_from_any(any);
+		return *this;
+	}
+
+	template <std::size_t _M, std::size_t _AlignM, class = std::enable_if_t<_M <= _N && _AlignM <= _Align>>
+	static_any& operator=(const static_any<_M, _AlignM>& any)
+	{
+		assign_from_any(any);
+		return *this;
+	}
+
+	template <std::size_t _M, std::size_t _AlignM, class = std::enable_if_t<_M <= _N && _AlignM <= _Align>>
+	static_any& operator=(static_any<_M, _AlignM>&& any)
+	{
+		assign_from_any(std::move(any));
+		return *this;
+	}
+
+	void reset();
+
+	template <class _T>
+	const _T& get() const;
+
+	template <class _T>
+	_T& get();
+
+	// same as get(), but returns nullptr instead of throwing if the type does not match
+	template <class _T>
+	const _T* try_get() const;
+
+	template <class _T>
+	_T* try_get();
+
+	template <class _T>
+	bool has() const;
+
+	// type(), type_id(), empty() and size() read the vtable without any call, and are defined in the class so that
+	// they stay inlined in the translation units using STATIC_ANY_EXTERN_TEMPLATE
+	const static_any_type_info& type() const { return empty() ? static_any_typeid<void>() : *__vtable->type_info; }
+
+	static_any_type_id_t type_id() const { return empty() ? static_any_type_id<void>::value : __vtable->type_id; }
+
+	// hash of the stored value and its type, 0 if empty. Throws bad_any_operation if the stored type
+	// has no std::hash
+	std::size_t hash() const;
+
+	bool empty() const { return __vtable == nullptr; }
+
+	// size of the stored type, 0 if empty
+	size_type size() const { return empty() ? 0 : __vtable->size; }
+
+	static constexpr size_type capacity();
+
+	static constexpr size_type alignment();
+
+	// basic guarantee: empty if the constructor of _T throws
+	template <class _T, class... Args>
+	void emplace(Args&&... args);
+
+	template <class _T, class... Args>
+	void emplace(static_any_basic_guarantee_t, Args&&... args);
+
+	template <class _T, class... Args>
+	void emplace(static_any_strong_guarantee_t, Args&&... args);
+
+	template <class _T, std::size_t _MaxSize, class... Args>
+	void emplace(static_any_double_buffer_guarantee_t<_MaxSize>, Args&&... args);
+
+	// assignment with the given guarantee -- operator= has the strong guarantee
+	template <class _Guarantee, class _T,
+			  class = std::enable_if_t<!is_static_any_v<std::decay_t<_T>>>>
+	void assign(_Guarantee guarantee, _T&& t)
+	{
+		emplace<std::decay_t<_T>>(guarantee, std::forward<_T>(t));
+	}
+
+private:
+	using vtable = detail::static_any::vtable;
+
+	template <class _T>
+	void copy_or_move(_T&& t);
+
+	template <class _T>
+	void assign_value(_T&& t, std::true_type /* nothrow */);
+
+	template <class _T>
+	void assign_value(_T&& t, std::false_type /* nothrow */);
+
+	template <class _T, class... Args>
+	void emplace_with_backup(std::true_type /* nothrow */, Args&&... args);
+
+	template <class _T, class... Args>
+	void emplace_with_backup(std::false_type /* nothrow */, Args&&... args);
+
+	template <class _T, class... Args>
+	void emplace_double_buffered(std::true_type /* double buffered */, Args&&... args);
+
+	template <class _T, class... Args>
+	void emplace_double_buffered(std::false_type /* double buffered */, Args&&... args);
+
+	template <class _T>
+	void assign_from_any(_T&&);
+
+	void backup(static_any& temp);
+
+	template <std::size_t _M, std::size_t _AlignM, class CopyOrMoveTag>
+	void assign_from_any(const static_any<_M, _AlignM>&, CopyOrMoveTag);
+
+	void destroy();
+
+	template <class _T>
+	const _T* as() const;
+
+	template <class _T>
+	_T* as();
+
+	static bool is_nothrow(const vtable* vt, detail::static_any::move_tag) { return vt->nothrow_move; }
+
+	static bool is_nothrow(const vtable* vt, detail::static_any::copy_tag) { return vt->nothrow_copy; }
+
+	template <std::size_t _M>
+	static void call_operation(const vtable* vt, void* this_void_ptr, void* other_void_ptr, detail::static_any::move_tag);
+
+	template <std::size_t _M>
+	static void call_operation(const vtable* vt, void* this_void_ptr, void* other_void_ptr, detail::static_any::copy_tag);
+
+	template <class _T>
+	void copy_or_move_from_another(_T&&);
+
+	alignas(_Align) std::array<char, _N> __buff;
+	const vtable* __vtable{};
+
+	template <std::size_t _S, std::size_t _A>
+	friend class static_any;
+
+	template <class _ValueT, std::size_t _S, std::size_t _A>
+	friend _ValueT* any_cast(static_any<_S, _A>*);
+
+	template <class _ValueT, std::size_t _S, std::size_t _A>
+	friend _ValueT& any_cast(static_any<_S, _A>&);
+
+	template <class... _Ts, std::size_t _S, std::size_t _A, class _Visitor>
+	friend bool visit(static_any<_S, _A>&, _Visitor&&);
+
+	template <class... _Ts, std::size_t _S, std::size_t _A, class _Visitor>
+	friend bool visit(const static_any<_S, _A>&, _Visitor&&);
+
+	template <std::size_t _S, std::size_t _A, class _Alloc>
+	friend class static_any_vector;
+
+	template <class _Signature, std::size_t _S, std::size_t _A>
+	friend class static_function;
+
+	template <class _Interface, std::size_t _S, std::size_t _A>
+	friend class static_poly;
+
+	template <std::size_t _S1, std::size_t _A1, std::size_t _S2, std::size_t _A2>
+	friend bool operator==(const static_any<_S1, _A1>&, const static_any<_S2, _A2>&);
+
+	template <std::size_t _S1, std::size_t _A1, std::size_t _S2, std::size_t _A2>
+	friend bool operator<(const static_any<_S1, _A1>&, const static_any<_S2, _A2>&);
+
+	template <std::size_t _S, std::size_t _A>
+	friend void destroy_range(static_any<_S, _A>*, static_any<_S, _A>*) noexcept;
+
+	template <std::size_t _S, std::size_t _A>
+	friend static_any<_S, _A>* uninitialized_copy_range(const static_any<_S, _A>*, const static_any<_S, _A>*, static_any<_S, _A>*);
+
+	template <std::size_t _S, std::size_t _A>
+	friend static_any<_S, _A>* uninitialized_relocate_range(static_any<_S, _A>*, static_any<_S, _A>*, static_any<_S, _A>*);
+};
+
+namespace detail { namespace static_any {
+
+template <class _T>
+struct operations
+{
+	static void copy(void* this_ptr, const void* other_ptr)
+	{
+		copy_if_copyable(this_ptr, other_ptr, std::is_copy_constructible<_T>{});
+	}
+
+	static void copy_if_copyable(void* this_ptr, const void* other_ptr, std::true_type)
+	{
+		assert(this_ptr);
+		assert(other_ptr);
+		new(this_ptr) _T(*reinterpret_cast<const _T*>(other_ptr));
+	}
+
+	static void copy_if_copyable(void*, const void*, std::false_type)
+	{
+		throw bad_any_copy(static_any_typeid<_T>());
+	}
+
+	static void move(void* this_ptr, void* other_ptr)
+	{
+		assert(this_ptr);
+		assert(other_ptr);
+		new(this_ptr) _T(std::move(*reinterpret_cast<_T*>(other_ptr)));
+	}
+
+	static void destroy(void* this_ptr)
+	{
+		assert(this_ptr);
+		reinterpret_cast<_T*>(this_ptr)->~_T();
+	}
+
+	static void copy_n(void* this_ptr, const void* other_ptr, std::size_t count, std::size_t stride)
+	{
+		copy_n_if_copyable(this_ptr, other_ptr, count, stride, std::is_copy_constructible<_T>{});
+	}
+
+	static void copy_n_if_copyable(void* this_ptr, const void* other_ptr, std::size_t count, std::size_t stride, std::true_type)
+	{
+		char* this_data = static_cast<char*>(this_ptr);
+		const char* other_data = static_cast<const char*>(other_ptr);
+		std::size_t i = 0;
+
+		try {
+			for (; i < count; ++i)
+				new(this_data + i * stride) _T(*reinterpret_cast<const _T*>(other_data + i * stride));
+		}
+		catch(...) {
+			destroy_n(this_ptr, i, stride);
+			throw;
+		}
+	}
+
+	static void copy_n_if_copyable(void*, const void*, std::size_t count, std::size_t, std::false_type)
+	{
+		if (count != 0)
+			throw bad_any_copy(static_any_typeid<_T>());
+	}
+
+	static void move_n(void* this_ptr, void* other_ptr, std::size_t count, std::size_t stride)
+	{
+		char* this_data = static_cast<char*>(this_ptr);
+		char* other_data = static_cast<char*>(other_ptr);
+		std::size_t i = 0;
+
+		try {
+			for (; i < count; ++i)
+				new(this_data + i * stride) _T(std::move(*reinterpret_cast<_T*>(other_data + i * stride)));
+		}
+		catch(...) {
+			destroy_n(this_ptr, i, stride);
+			throw;
+		}
+	}
+
+	static void destroy_n(void* this_ptr, std::size_t count, std::size_t stride)
+	{
+		char* this_data = static_cast<char*>(this_ptr);
+		for (std::size_t i = 0; i < count; ++i)
+			reinterpret_cast<_T*>(this_data + i * stride)->~_T();
+	}
+
+	static std::size_t hash(const void* this_ptr)
+	{
+		return hash_if_hashable(this_ptr, opted_in<_T, is_hashable<_T>>{});
+	}
+
+	static std::size_t hash_if_hashable(const void* this_ptr, std::true_type)
+	{
+		return std::hash<_T>{}(*reinterpret_cast<const _T*>(this_ptr));
+	}
+
+	static std::size_t hash_if_hashable(const void*, std::false_type)
+	{
+		throw bad_any_operation(static_any_typeid<_T>());
+	}
+
+	static bool equals(const void* this_ptr, const void* other_ptr)
+	{
+		return equals_if_comparable(this_ptr, other_ptr, opted_in<_T, is_equality_comparable<_T>>{});
+	}
+
+	static bool equals_if_comparable(const void* this_ptr, const void* other_ptr, std::true_type)
+	{
+		return static_cast<bool>(*reinterpret_cast<const _T*>(this_ptr) == *reinterpret_cast<const _T*>(other_ptr));
+	}
+
+	static bool equals_if_comparable(const void*, const void*, std::false_type)
+	{
+		throw bad_any_operation(static_any_typeid<_T>());
+	}
+
+	static bool less(const void* this_ptr, const void* other_ptr)
+	{
+		return less_if_comparable(this_ptr, other_ptr, opted_in<_T, is_less_comparable<_T>>{});
+	}
+
+	static bool less_if_comparable(const void* this_ptr, const void* other_ptr, std::true_type)
+	{
+		return static_cast<bool>(*reinterpret_cast<const _T*>(this_ptr) < *reinterpret_cast<const _T*>(other_ptr));
+	}
+
+	static bool less_if_comparable(const void*, const void*, std::false_type)
+	{
+		throw bad_any_operation(static_any_typeid<_T>());
+	}
+};
+
+template <class _T>
+struct is_trivially_copyable :
+#if __GNUG__ && __GNUC__ < 5
+	public std::integral_constant<bool, std::has_trivial_copy_constructor<_T>::value && std::is_trivially_destructible<_T>::value>
+#else
+	public std::is_trivially_copyable<_T>
+#endif
+{};
+
+#if defined(STATIC_ANY_INSTRUMENTATION)
+
+// Counters of a stored type, registered in a global list the first time one is incremented. Each shared
+// library has its own list, as it has its own vtables.
+struct type_stats
+{
+	constexpr explicit type_stats(const static_any_type_info* info) : type_info(info) {}
+
+	const static_any_type_info* type_info;
+
+	std::atomic<std::uint64_t> copies{0};
+	std::atomic<std::uint64_t> moves{0};
+	std::atomic<std::uint64_t> destroys{0};
+	std::atomic<std::uint64_t> backups{0};
+	std::atomic<std::uint64_t> slow_type_checks{0};
+	std::atomic<std::uint64_t> failed_casts{0};
+
+	std::atomic<bool> registered{false};
+	type_stats* next = nullptr;
+};
+
+template <class _T>
+struct type_stats_for
+{
+	static type_stats value;
+};
+
+template <class _T>
+type_stats type_stats_for<_T>::value{type_info_for<_T>::value};
+
+inline std::atomic<type_stats*>& stats_registry()
+{
+	static std::atomic<type_stats*> head{nullptr};
+	return head;
+}
+
+inline void register_stats(type_stats& stats)
+{
+	if (stats.registered.exchange(true))
+		return;
+
+	std::atomic<type_stats*>& head = stats_registry();
+	type_stats* first = head.load(std::memory_order_relaxed);
+	do
+	{
+		stats.next = first;
+	}
+	while (!head.compare_exchange_weak(first, &stats, std::memory_order_release, std::memory_order_relaxed));
+}
+
+inline void count_operation(const vtable* vt, std::atomic<std::uint64_t> type_stats::*counter, std::size_t count)
+{
+	type_stats& stats = *vt->stats;
+	if (!stats.registered.load(std::memory_order_relaxed))
+		register_stats(stats);
+
+	(stats.*counter).fetch_add(count, std::memory_order_relaxed);
+}
+
+#endif
+
+template <class _T>
+struct is_registered_type :
+	public std::integral_constant<bool, !std::is_base_of<hashed_type_id<_T>, static_any_type_id<_T>>::value>
+{};
+
+// static_any_type_id<_T> identifies _T in the whole program: registered, or hashed from a name no other type has.
+// Otherwise, the type checks only rely on the vtables or std::type_info, and the types can not be stored in the
+// containers identifying their values by type_id -- static_any_tagged_t, static_record.
+template <class _T>
+struct has_unique_type_id :
+	public std::integral_constant<bool, is_registered_type<_T>::value || type_name_is_unique<_T>()>
+{};
+
+// type id of the types stored by the containers identifying their values by type_id
+template <class _T>
+constexpr static_any_type_id_t unique_type_id()
+{
+	static_assert(has_unique_type_id<_T>::value,
+				  "the type id of _T is not unique -- lambda, local type or type of an anonymous namespace: register it with static_any_type_id");
+	return static_any_type_id<_T>::value;
+}
+
+template <class _T>
+struct vtable_for
+{
+	static constexpr bool trivial_copy = is_trivially_copyable<_T>::value && std::is_copy_constructible<_T>::value;
+	static constexpr bool trivial_move = is_trivially_copyable<_T>::value && std::is_move_constructible<_T>::value;
+
+	static constexpr vtable value =
+	{
+		type_info_for<_T>::value,
+		static_any_type_id<_T>::value,
+		has_unique_type_id<_T>::value,
+		sizeof(_T),
+		alignof(_T),
+		std::is_copy_constructible<_T>::value,
+		std::is_nothrow_copy_constructible<_T>::value,
+		std::is_nothrow_move_constructible<_T>::value,
+		trivial_copy ? nullptr : &operations<_T>::copy,
+		trivial_move ? nullptr : &operations<_T>::move,
+		std::is_trivially_destructible<_T>::value ? nullptr : &operations<_T>::destroy,
+		trivial_copy ? nullptr : &operations<_T>::copy_n,
+		trivial_move ? nullptr : &operations<_T>::move_n,
+		std::is_trivially_destructible<_T>::value ? nullptr : &operations<_T>::destroy_n,
+		&operations<_T>::hash,
+		&operations<_T>::equals,
+		&operations<_T>::less
+#if defined(STATIC_ANY_INSTRUMENTATION)
+		, &type_stats_for<_T>::value
+#endif
+	};
+};
+
+template <class _T>
+constexpr vtable vtable_for<_T>::value;
+
+template <class _T>
+inline const vtable* get_vtable_for_type()
+{
+	return &vtable_for<std::remove_cv_t<std::remove_reference_t<_T>>>::value;
+}
+
+// slow path of the type check, when the vtables are different: the value may come from another DLL
+template <class _T>
+inline bool is_same_type(const vtable* vt)
+{
+	assert(vt != nullptr);
+	STATIC_ANY_COUNT(vt, slow_type_checks);
+
+	// a const static_any gets a const _T, while the id of the value is the one of _T
+	using type = std::remove_cv_t<_T>;
+
+#if defined(STATIC_ANY_USE_TYPE_ID)
+	return has_unique_type_id<type>::value && vt->unique_type_id && vt->type_id == static_any_type_id<type>::value;
+#else
+	if (is_registered_type<type>::value)
+		return vt->type_id == static_any_type_id<type>::value;
+
+	return static_any_typeid<type>() == *vt->type_info;
+#endif
+}
+
+template <class _T>
+inline bool has_type(const vtable* vt)
+{
+	if (vt == get_vtable_for_type<_T>())
+	{
+		return true;
+	}
+	else if (vt)
+	{
+		// need to try another, possibly more costly way, as we may compare types across DLL boundaries
+		return is_same_type<_T>(vt);
+	}
+	return false;
+}
+
+inline static_any_type_id_t type_id(const vtable* vt)
+{
+	return vt == nullptr ? static_any_type_id<void>::value : vt->type_id;
+}
+
+// true if both vtables are for the same type, possibly coming from different DLLs
+inline bool is_same_type(const vtable* vt1, const vtable* vt2)
+{
+	if (vt1 == vt2)
+		return true;
+	else if (vt1 == nullptr || vt2 == nullptr)
+		return false;
+
+	STATIC_ANY_COUNT(vt1, slow_type_checks);
+
+#if defined(STATIC_ANY_USE_TYPE_ID)
+	return vt1->unique_type_id && vt2->unique_type_id && vt1->type_id == vt2->type_id;
+#else
+	return *vt1->type_info == *vt2->type_info;
+#endif
+}
+
+// order of the types of two values compared with operator<, the empty static_any being first
+inline bool is_type_before(const vtable* vt1, const vtable* vt2)
+{
+	if (vt1 == nullptr || vt2 == nullptr)
+		return vt1 == nullptr && vt2 != nullptr;
+
+#if defined(STATIC_ANY_USE_TYPE_ID)
+	if (vt1->type_id != vt2->type_id)
+		return vt1->type_id < vt2->type_id;
+
+	// different types with the same id, which is not unique: ordered by their vtables
+	return !is_same_type(vt1, vt2) && std::less<const vtable*>()(vt1, vt2);
+#else
+	return vt1->type_info->before(*vt2->type_info);
+#endif
+}
+
+// range operations on count values separated by stride bytes, with the same semantic as the vtable
+// entries: trivial operations are done with a single memcpy, or nothing at all
+inline void copy_n(const vtable* vt, void* this_ptr, const void* other_ptr, std::size_t count, std::size_t stride)
+{
+	STATIC_ANY_COUNT_N(vt, copies, count);
+
+	if (vt->copy_n)
+		vt->copy_n(this_ptr, other_ptr, count, stride);
+	else if (count != 0)
+		std::memcpy(this_ptr, other_ptr, count * stride);
+}
+
+inline void move_n(const vtable* vt, void* this_ptr, void* other_ptr, std::size_t count, std::size_t stride)
+{
+	STATIC_ANY_COUNT_N(vt, moves, count);
+
+	if (vt->move_n)
+		vt->move_n(this_ptr, other_ptr, count, stride);
+	else if (count != 0)
+		std::memcpy(this_ptr, other_ptr, count * stride);
+}
+
+inline void destroy_n(const vtable* vt, void* this_ptr, std::size_t count, std::size_t stride)
+{
+	STATIC_ANY_COUNT_N(vt, destroys, count);
+
+	if (vt->destroy_n)
+		vt->destroy_n(this_ptr, count, stride);
+}
+
+// when the storage of a value has to change, a value is moved if it cannot throw or if it cannot be copied,
+// otherwise it is copied so that the original value is left untouched if an exception is thrown
+inline bool relocate_by_move(const vtable* vt)
+{
+	return vt->nothrow_move || !vt->copyable;
+}
+
+// position of _T in _Ts, sizeof...(_Ts) if it is not one of them
+template <class _T, class... _Ts>
+struct index_of : public std::integral_constant<std::size_t, 0> {};
+
+template <class _T, class _First, class... _Rest>
+struct index_of<_T, _First, _Rest...> :
+	public std::integral_constant<std::size_t, std::is_same<_T, _First>::value ? 0 : 1 + index_of<_T, _Rest...>::value>
+{};
+
+// Type ids of candidate types, sorted, with the position of each type in the list of candidates
+template <std::size_t _Count>
+struct sorted_type_ids
+{
+	static_any_type_id_t ids[_Count];
+	std::size_t indices[_Count];
+};
+
+// insertion sort, stable: the first of duplicate candidates comes first
+template <std::size_t _Count>
+constexpr sorted_type_ids<_Count> sort_type_ids(sorted_type_ids<_Count> sorted)
+{
+	for (std::size_t i = 0; i < _Count; ++i)
+		sorted.indices[i] = i;
+
+	for (std::size_t i = 1; i < _Count; ++i)
+	{
+		const static_any_type_id_t id = sorted.ids[i];
+		const std::size_t index = sorted.indices[i];
+
+		std::size_t j = i;
+		for (; j > 0 && id < sorted.ids[j - 1]; --j)
+		{
+			sorted.ids[j] = sorted.ids[j - 1];
+			sorted.indices[j] = sorted.indices[j - 1];
+		}
+		sorted.ids[j] = id;
+		sorted.indices[j] = index;
+	}
+	return sorted;
+}
+
+// Dispatch over a closed list of types: the type id of the stored value is looked up by a binary search in
+// the sorted ids of the candidate types, then checked once against the candidate found -- a comparison of
+// vtables, falling back to the slow type check only for a value from another DLL. A value of another type
+// costs the search alone. The visitor is then called through a table of thunks indexed by the position found.
+template <class... _Ts>
+struct visit_table
+{
+	static_assert(sizeof...(_Ts) > 0, "visit needs at least one candidate type");
+
+	static constexpr std::size_t npos = sizeof...(_Ts);
+
+	static constexpr sorted_type_ids<npos> sorted =
+		sort_type_ids(sorted_type_ids<npos>{{ static_any_type_id<std::remove_cv_t<std::remove_reference_t<_Ts>>>::value... }, {}});
+
+	static std::size_t find(const vtable* vt)
+	{
+		using check_t = bool(*)(const vtable*);
+		static constexpr check_t checks[] = { &has_type<_Ts>... };
+
+		if (vt == nullptr)
+			return npos;
+
+		// lower bound of the id
+		std::size_t first = 0;
+		std::size_t count = npos;
+		while (count > 0)
+		{
+			const std::size_t half = count / 2;
+			if (sorted.ids[first + half] < vt->type_id)
+			{
+				first += half + 1;
+				count -= half + 1;
+			}
+			else
+			{
+				count = half;
+			}
+		}
+
+		// several candidates share an id only if their names are not unique, lambdas for instance
+		for (; first < npos && sorted.ids[first] == vt->type_id; ++first)
+		{
+			if (checks[sorted.indices[first]](vt))
+				return sorted.indices[first];
+		}
+
+		return npos;
+	}
+
+	template <class _Ptr, class _Visitor>
+	static bool call(std::size_t index, _Ptr* ptr, _Visitor& visitor)
+	{
+		using thunk_t = void(*)(_Ptr*, _Visitor&);
+		static constexpr thunk_t thunks[] = { &thunk<std::conditional_t<std::is_const<_Ptr>::value, const _Ts, _Ts>, _Ptr, _Visitor>... };
+
+		if (index == npos)
+			return false;
+
+		thunks[index](ptr, visitor);
+		return true;
+	}
+
+private:
+	template <class _T, class _Ptr, class _Visitor>
+	static void thunk(_Ptr* ptr, _Visitor& visitor)
+	{
+		visitor(*static_cast<_T*>(ptr));
+	}
+};
+
+template <class... _Ts>
+constexpr sorted_type_ids<visit_table<_Ts...>::npos> visit_table<_Ts...>::sorted;
+
+}}
+
+template <std::size_t _N, std::size_t _Align>
+static_any<_N, _Align>::static_any()
+{}
+
+template <std::size_t _N, std::size_t _Align>
+static_any<_N, _Align>::~static_any()
+{
+	destroy();
+}
+
+template <std::size_t _N, std::size_t _Align>
+template <class _T, class>
+static_any<_N, _Align>::static_any(_T&& v)
+{
+	copy_or_move(std::forward<_T>(v));
+}
+
+template <std::size_t _N, std::size_t _Align>
+static_any<_N, _Align>::static_any(const static_any<_N, _Align>& another)
+{
+	copy_or_move_from_another(another);
+}
+
+template <std::size_t _N, std::size_t _Align>
+static_any<_N, _Align>::static_any(static_any<_N, _Align>&& another)
+{
+	copy_or_move_from_another(std::move(another));
+}
+
+template <std::size_t _N, std::size_t _Align>
+template <class _T, class... Args>
+static_any<_N, _Align>::static_any(static_any_in_place_type_t<_T>, Args&&... args)
+{
+	static_assert(capacity() >= sizeof(_T), "_T is too big to be emplaced in static_any");
+	static_assert(alignment() >= alignof(_T), "_T is over-aligned for static_any");
+
+	new(__buff.data()) _T(std::forward<Args>(args)...);
+	__vtable = detail::static_any::get_vtable_for_type<_T>();
+}
+
+template <std::size_t _N, std::size_t _Align>
+template <std::size_t _M, std::size_t _AlignM, class>
+static_any<_N, _Align>::static_any(const static_any<_M, _AlignM>& another)
+{
+	copy_or_move_from_another(another);
+}
+
+template <std::size_t _N, std::size_t _Align>
+template <std::size_t _M, std::size_t _AlignM, class>
+static_any<_N, _Align>::static_any(static_any<_M, _AlignM>&& another)
+{
+	copy_or_move_from_another(std::move(another));
+}
+
+template <std::size_t _N, std::size_t _Align>
+template <class _T, class>
+static_any<_N, _Align>& static_any<_N, _Align>::operator=(_T&& t)
+{
+	static_assert(capacity() >= sizeof(_T), "_T is too big to be copied to static_any");
+	static_assert(alignment() >= alignof(std::remove_reference_t<_T>), "_T is over-aligned for static_any");
+
+	using NonConstT = std::remove_cv_t<std::remove_reference_t<_T>>;
+	using IsNothrow = std::integral_constant<bool,
+		std::is_rvalue_reference<_T&&>::value ?
+			std::is_nothrow_move_constructible<NonConstT>::value :
+			std::is_nothrow_copy_constructible<NonConstT>::value>;
+
+	assign_value(std::forward<_T>(t), IsNothrow{});
+	return *this;
+}
+
+template <std::size_t _N, std::size_t _Align>
+template <class _T>
+void static_any<_N, _Align>::assign_value(_T&& t, std::true_type)
+{
+	// the copy or move cannot throw: no need to backup the current value
+	destroy();
+	copy_or_move(std::forward<_T>(t));
+}
+
+template <std::size_t _N, std::size_t _Align>
+template <class _T>
+void static_any<_N, _Align>::assign_value(_T&& t, std::false_type)
+{
+	static_any temp;
+	backup(temp);
+
+	try
+	{
+		destroy();
+		assert(__vtable == nullptr);
+
+		copy_or_move(std::forward<_T>(t));
+	}
+	catch(...)
+	{
+		*this = std::move(temp);
+		throw;
+	}
+}
+
+template <std::size_t _N, std::size_t _Align>
+void static_any<_N, _Align>::reset() { destroy(); }
+
+template <std::size_t _N, std::size_t _Align>
+template <class _T>
+bool static_any<_N, _Align>::has() const
+{
+	return detail::static_any::has_type<_T>(__vtable);
+}
+
+template <std::size_t _N, std::size_t _Align>
+std::size_t static_any<_N, _Align>::hash() const
+{
+	if (empty())
+		return 0;
+
+	const std::size_t type_hash = std::hash<static_any_type_id_t>{}(__vtable->type_id);
+	return detail::static_any::hash_combine(type_hash, __vtable->hash(__buff.data()));
+}
+
+template <std::size_t _N, std::size_t _Align>
+constexpr typename static_any<_N, _Align>::size_type static_any<_N, _Align>::capacity()
+{
+	return _N;
+}
+
+template <std::size_t _N, std::size_t _Align>
+constexpr typename static_any<_N, _Align>::size_type static_any<_N, _Align>::alignment()
+{
+	return _Align;
+}
+
+template <std::size_t _N, std::size_t _Align>
+template <class _T, class... Args>
+void static_any<_N, _Align>::emplace(Args&&... args)
+{
+	static_assert(capacity() >= sizeof(_T), "_T is too big to be emplaced in static_any");
+	static_assert(alignment() >= alignof(_T), "_T is over-aligned for static_any");
+
+	destroy();
+	new(__buff.data()) _T(std::forward<Args>(args)...);
+	__vtable = detail::static_any::get_vtable_for_type<_T>();
+}
+
+template <std::size_t _N, std::size_t _Align>
+template <class _T, class... Args>
+void static_any<_N, _Align>::emplace(static_any_basic_guarantee_t, Args&&... args)
+{
+	emplace<_T>(std::forward<Args>(args)...);
+}
+
+template <std::size_t _N, std::size_t _Align>
+template <class _T, class... Args>
+void static_any<_N, _Align>::emplace(static_any_strong_guarantee_t, Args&&... args)
+{
+	emplace_with_backup<_T>(std::is_nothrow_constructible<_T, Args&&...>{}, std::forward<Args>(args)...);
+}
+
+template <std::size_t _N, std::size_t _Align>
+template <class _T, std::size_t _MaxSize, class... Args>
+void static_any<_N, _Align>::emplace(static_any_double_buffer_guarantee_t<_MaxSize>, Args&&... args)
+{
+	using IsDoubleBuffered = std::integral_constant<bool,
+		!std::is_nothrow_constructible<_T, Args&&...>::value &&
+		std::is_nothrow_move_constructible<_T>::value &&
+		sizeof(_T) <= _MaxSize>;
+
+	emplace_double_buffered<_T>(IsDoubleBuffered{}, std::forward<Args>(args)...);
+}
+
+template <std::size_t _N, std::size_t _Align>
+template <class _T, class... Args>
+void static_any<_N, _Align>::emplace_with_backup(std::true_type, Args&&... args)
+{
+	emplace<_T>(std::forward<Args>(args)...);
+}
+
+template <std::size_t _N, std::size_t _Align>
+template <class _T, class... Args>
+void static_any<_N, _Align>::emplace_with_backup(std::false_type, Args&&... args)
+{
+	static_any temp;
+	backup(temp);
+
+	try
+	{
+		emplace<_T>(std::forward<Args>(args)...);
+	}
+	catch(...)
+	{
+		*this = std::move(temp);
+		throw;
+	}
+}
+
+template <std::size_t _N, std::size_t _Align>
+template <class _T, class... Args>
+void static_any<_N, _Align>::emplace_double_buffered(std::true_type, Args&&... args)
+{
+	static_assert(capacity() >= sizeof(_T), "_T is too big to be emplaced in static_any");
+	static_assert(alignment() >= alignof(_T), "_T is over-aligned for static_any");
+
+	// the current value is untouched if the constructor throws
+	std::aligned_storage_t<sizeof(_T), alignof(_T)> buffer;
+	_T* t = new(&buffer) _T(std::forward<Args>(args)...);
+
+	destroy();
+	new(__buff.data()) _T(std::move(*t));
+	__vtable = detail::static_any::get_vtable_for_type<_T>();
+	t->~_T();
+}
+
+template <std::size_t _N, std::size_t _Align>
+template <class _T, class... Args>
+void static_any<_N, _Align>::emplace_double_buffered(std::false_type, Args&&... args)
+{
+	emplace<_T>(static_any_strong_guarantee, std::forward<Args>(args)...);
+}
+
+template <std::size_t _N, std::size_t _Align>
+template <class _T>
+void static_any<_N, _Align>::copy_or_move(_T&& t)
+{
+	static_assert(capacity() >= sizeof(_T), "_T is too big to be copied to static_any");
+	static_assert(alignment() >= alignof(std::remove_reference_t<_T>), "_T is over-aligned for static_any");
+	assert(__vtable == nullptr);
+
+	using NonConstT = std::remove_cv_t<std::remove_reference_t<_T>>;
+
+	new(__buff.data()) NonConstT(std::forward<_T>(t));
+	__vtable = detail::static_any::get_vtable_for_type<_T>();
+
+	if (std::is_rvalue_reference<_T&&>::value)
+		STATIC_ANY_COUNT(__vtable, moves);
+	else
+		STATIC_ANY_COUNT(__vtable, copies);
+}
+
+template <std::size_t _N, std::size_t _Align>
+template <class _T>
+void static_any<_N, _Align>::assign_from_any(_T&& t)
+{
+	using CopyOrMoveTag = typename std::conditional<
+		std::is_rvalue_reference<_T&&>::value,
+			detail::static_any::move_tag,
+			detail::static_any::copy_tag
+		>::type;
+
+	assign_from_any(std::forward<_T>(t), CopyOrMoveTag{});
+}
+
+template <std::size_t _N, std::size_t _Align>
+template <std::size_t _M, std::size_t _AlignM, class CopyOrMoveTag>
+void static_any<_N, _Align>::assign_from_any(const static_any<_M, _AlignM>& another, CopyOrMoveTag)
+{
+	if (another.__vtable == nullptr)
+	{
+		destroy();
+		return;
+	}
+
+	void* other_data = reinterpret_cast<void*>(const_cast<char*>(another.__buff.data()));
+
+	if (is_nothrow(another.__vtable, CopyOrMoveTag{}))
+	{
+		destroy();
+		call_operation<_M>(another.__vtable, __buff.data(), other_data, CopyOrMoveTag{});
+		__vtable = another.__vtable;
+		return;
+	}
+
+	static_any temp;
+	backup(temp);
+
+	try {
+		destroy();
+		assert(__vtable == nullptr);
+
+		call_operation<_M>(another.__vtable, __buff.data(), other_data, CopyOrMoveTag{});
+	}
+	catch(...) {
+		*this = std::move(temp);
+		throw;
+	}
+
+	__vtable = another.__vtable;
+}
+
+template <std::size_t _N, std::size_t _Align>
+void static_any<_N, _Align>::backup(static_any& temp)
+{
+	// same as std::move_if_noexcept, but on the stored type: move-only types are moved in any case
+	if (__vtable == nullptr)
+		return;
+
+	STATIC_ANY_COUNT(__vtable, backups);
+
+	if (__vtable->nothrow_move || !__vtable->copyable)
+		temp.copy_or_move_from_another(std::move(*this));
+	else
+		temp.copy_or_move_from_another(*this);
+}
+
+template <std::size_t _N, std::size_t _Align>
+void static_any<_N, _Align>::destroy()
+{
+	if (__vtable)
+	{
+		STATIC_ANY_COUNT(__vtable, destroys);
+
+		if (__vtable->destroy)
+			__vtable->destroy(__buff.data());
+		__vtable = nullptr;
+	}
+}
+
+template <std::size_t _N, std::size_t _Align>
+template <class _T>
+const _T* static_any<_N, _Align>::as() const
+{
+	return reinterpret_cast<const _T*>(__buff.data());
+}
+
+template <std::size_t _N, std::size_t _Align>
+template <class _T>
+_T* static_any<_N, _Align>::as()
+{
+	return reinterpret_cast<_T*>(__buff.data());
+}
+
+template <std::size_t _N, std::size_t _Align>
+template <std::size_t _M>
+void static_any<_N, _Align>::call_operation(const vtable* vt, void* this_void_ptr, void* other_void_ptr, detail::static_any::move_tag)
+{
+	STATIC_ANY_COUNT(vt, moves);
+
+	// copying the whole source buffer: a memcpy with a size known at compile time is inlined
+	if (vt->move)
+		vt->move(this_void_ptr, other_void_ptr);
+	else
+		std::memcpy(this_void_ptr, other_void_ptr, _M);
+}
+
+template <std::size_t _N, std::size_t _Align>
+template <std::size_t _M>
+void static_any<_N, _Align>::call_operation(const vtable* vt, void* this_void_ptr, void* other_void_ptr, detail::static_any::copy_tag)
+{
+	STATIC_ANY_COUNT(vt, copies);
+
+	if (vt->copy)
+		vt->copy(this_void_ptr, other_void_ptr);
+	else
+		std::memcpy(this_void_ptr, other_void_ptr, _M);
+}
+
+template <std::size_t _N, std::size_t _Align>
+template <class _T>
+void static_any<_N, _Align>::copy_or_move_from_another(_T&& another)
+{
+	assert(__vtable == nullptr);
+
+	if (another.__vtable == nullptr)
+	{
+		return;
+	}
+
+	using Tag = typename std::conditional<std::is_rvalue_reference<_T&&>::value,
+				detail::static_any::move_tag,
+				detail::static_any::copy_tag>::type;
+
+	void* other_data = reinterpret_cast<void*>(const_cast<char*>(another.__buff.data()));
+
+	call_operation<std::decay_t<_T>::capacity()>(another.__vtable, __buff.data(), other_data, Tag{});
+	__vtable = another.__vtable;
+}
+
+class bad_any_cast : public std::bad_cast
+{
+public:
+	// the message is written in an inline buffer: throwing does not allocate nor format through iostreams
+	explicit bad_any_cast(const static_any_type_info& from,
+						  const static_any_type_info& to) :
+		__from(from),
+		__to(to)
+	{
+		char* out = __reason;
+		const char* end = __reason + sizeof(__reason) - 1;
+
+		append(out, end, "failed conversion using any_cast: stored type ");
+		append(out, end, from.name());
+		append(out, end, ", trying to cast to ");
+		append(out, end, to.name());
+		*out = '\0';
+	}
+
+	const static_any_type_info& stored_type() const { return __from; }
+	const static_any_type_info& target_type() const { return __to; }
+
+	const char* what() const noexcept override
+	{
+		return __reason;
+	}
+
+private:
+	static void append(char*& out, const char* end, const char* str)
+	{
+		while (out != end && *str != '\0')
+			*out++ = *str++;
+	}
+
+	const static_any_type_info& __from;
+	const static_any_type_info& __to;
+	char __reason[256];
+};
+
+template <class _ValueT,
+		  std::size_t _S,
+		  std::size_t _A>
+inline _ValueT* any_cast(static_any<_S, _A>* a)
+{
+	if (!a->template has<_ValueT>())
+		return nullptr;
+
+	return a->template as<_ValueT>();
+}
+
+template <class _ValueT,
+		  std::size_t _S,
+		  std::size_t _A>
+inline const _ValueT* any_cast(const static_any<_S, _A>* a)
+{
+	return any_cast<const _ValueT>(const_cast<static_any<_S, _A>*>(a));
+}
+
+template <class _ValueT,
+		  std::size_t _S,
+		  std::size_t _A>
+inline _ValueT& any_cast(static_any<_S, _A>& a)
+{
+	if (!a.template has<_ValueT>())
+	{
+		if (a.__vtable)
+			STATIC_ANY_COUNT(a.__vtable, failed_casts);
+		throw bad_any_cast(a.type(), static_any_typeid<_ValueT>());
+	}
+
+	return *a.template as<_ValueT>();
+}
+
+template <class _ValueT,
+		  std::size_t _S,
+		  std::size_t _A>
+inline const _ValueT& any_cast(const static_any<_S, _A>& a)
+{
+	return any_cast<const _ValueT>(const_cast<static_any<_S, _A>&>(a));
+}
+
+// static_any just big and aligned enough to hold any of _Ts: its size follows the types as they change
+template <class... _Ts>
+using static_any_for = static_any<detail::static_any::max_value(sizeof(_Ts)...), detail::static_any::max_value(alignof(_Ts)...)>;
+
+// a static_any<_N> holding a _T constructed in place from args
+template <std::size_t _N, class _T, class... Args>
+inline static_any<_N> make_static_any(Args&&... args)
+{
+	return static_any<_N>(static_any_in_place_type<_T>, std::forward<Args>(args)...);
+}
+
+template <std::size_t _S, std::size_t _A>
+template <class _T>
+const _T& static_any<_S, _A>::get() const
+{
+	return any_cast<_T>(*this);
+}
+
+template <std::size_t _S, std::size_t _A>
+template <class _T>
+_T& static_any<_S, _A>::get()
+{
+	return any_cast<_T>(*this);
+}
+
+template <std::size_t _S, std::size_t _A>
+template <class _T>
+const _T* static_any<_S, _A>::try_get() const
+{
+	return any_cast<_T>(this);
+}
+
+template <std::size_t _S, std::size_t _A>
+template <class _T>
+_T* static_any<_S, _A>::try_get()
+{
+	return any_cast<_T>(this);
+}
+
+// Calls the visitor with the stored value if its type is one of _Ts. Returns false if the static_any is
+// empty or holds another type.
+template <class... _Ts,
+		  std::size_t _S,
+		  std::size_t _A,
+		  class _Visitor>
+inline bool visit(static_any<_S, _A>& a, _Visitor&& visitor)
+{
+	using table = detail::static_any::visit_table<_Ts...>;
+	return table::call(table::find(a.__vtable), static_cast<void*>(a.__buff.data()), visitor);
+}
+
+template <class... _Ts,
+		  std::size_t _S,
+		  std::size_t _A,
+		  class _Visitor>
+inline bool visit(const static_any<_S, _A>& a, _Visitor&& visitor)
+{
+	using table = detail::static_any::visit_table<_Ts...>;
+	return table::call(table::find(a.__vtable), static_cast<const void*>(a.__buff.data()), visitor);
+}
+
+template <std::size_t _N, std::size_t _Align>
+class static_unique_any : private static_any<_N, _Align>
+{
+	using base = static_any<_N, _Align>;
+
+	template <class _T>
+	static constexpr bool is_static_any_v = base::template is_static_any_v<_T>;
+
+public:
+	using typename base::size_type;
+
+	static_unique_any() = default;
+
+	template <class _T,
+			  class = std::enable_if_t<!is_static_any_v<std::decay_t<_T>>>>
+	static_unique_any(_T&& t) :
+		base(std::forward<_T>(t))
+	{}
+
+	template <class _T, class... Args>
+	explicit static_unique_any(static_any_in_place_type_t<_T> tag, Args&&... args) :
+		base(tag, std::forward<Args>(args)...)
+	{}
+
+	static_unique_any(const static_unique_any&) = delete;
+
+	static_unique_any(static_unique_any&& another) :
+		base(another.as_static_any())
+	{}
+
+	template <std::size_t _M, std::size_t _AlignM, class = std::enable_if_t<_M <= _N && _AlignM <= _Align>>
+	static_unique_any(static_unique_any<_M, _AlignM>&& another) :
+		base(another.as_static_any())
+	{}
+
+	template <class _T,
+			  class = std::enable_if_t<!is_static_any_v<std::decay_t<_T>>>>
+	static_unique_any& operator=(_T&& t)
+	{
+		base::operator=(std::forward<_T>(t));
+		return *this;
+	}
+
+	static_unique_any& operator=(const static_unique_any&) = delete;
+
+	static_unique_any& operator=(static_unique_any&& another)
+	{
+		base::operator=(another.as_static_any());
+		return *this;
+	}
+
+	template <std::size_t _M, std::size_t _AlignM, class = std::enable_if_t<_M <= _N && _AlignM <= _Align>>
+	static_unique_any& operator=(static_unique_any<_M, _AlignM>&& another)
+	{
+		base::operator=(another.as_static_any());
+		return *this;
+	}
+
+	using base::reset;
+	using base::get;
+	using base::try_get;
+	using base::has;
+	using base::type;
+	using base::type_id;
+	using base::empty;
+	using base::size;
+	using base::capacity;
+	using base::alignment;
+	using base::emplace;
+	using base::assign;
+
+private:
+	base&& as_static_any() { return static_cast<base&&>(*this); }
+
+	template <std::size_t _S, std::size_t _A>
+	friend class static_unique_any;
+};
+
+template <class _ValueT,
+		  std::size_t _S,
+		  std::size_t _A>
+inline _ValueT* any_cast(static_unique_any<_S, _A>* a)
+{
+	return a->template has<_ValueT>() ? &a->template get<_ValueT>() : nullptr;
+}
+
+template <class _ValueT,
+		  std::size_t _S,
+		  std::size_t _A>
+inline const _ValueT* any_cast(const static_unique_any<_S, _A>* a)
+{
+	return a->template has<_ValueT>() ? &a->template get<_ValueT>() : nullptr;
+}
+
+template <class _ValueT,
+		  std::size_t _S,
+		  std::size_t _A>
+inline _ValueT& any_cast(static_unique_any<_S, _A>& a)
+{
+	return a.template get<_ValueT>();
+}
+
+template <class _ValueT,
+		  std::size_t _S,
+		  std::size_t _A>
+inline const _ValueT& any_cast(const static_unique_any<_S, _A>& a)
+{
+	return a.template get<_ValueT>();
+}
+
+
+template <std::size_t _N, std::size_t _Align = detail::static_any::natural_alignment(_N)>
+class static_any_t
+{
+	static_assert(_Align != 0 && (_Align & (_Align - 1)) == 0, "_Align has to be a power of two");
+
+public:
+	using size_type = std::size_t;
+
+	static constexpr size_type capacity() { return _N; }
+
+	static constexpr size_type alignment() { return _Align; }
+
+	static_any_t() = default;
+	static_any_t(const static_any_t&) = default;
+
+	// constexpr when STATIC_ANY_HAS_CONSTEXPR_T is defined, for the types std::bit_cast supports in constant
+	// expressions -- no pointers nor unions. The bytes after the value are then zero-filled.
+	template <class _ValueT>
+	STATIC_ANY_CONSTEXPR_T static_any_t(_ValueT&& t)
+	{
+		copy(std::forward<_ValueT>(t));
+	}
+
+	template <class _ValueT>
+	STATIC_ANY_CONSTEXPR_T static_any_t& operator=(_ValueT&& t)
+	{
+		copy(std::forward<_ValueT>(t));
+		return *this;
+	}
+
+	template <class _ValueT>
+	_ValueT& get() { return *reinterpret_cast<_ValueT*>(__buff.data()); }
+
+	template <class _ValueT>
+	const _ValueT& get() const { return *reinterpret_cast<const _ValueT*>(__buff.data()); }
+
+	// byte-wise hash and comparison of the stored _ValueT: two values are equal if their object
+	// representations are the same
+	template <class _ValueT>
+	std::size_t hash() const
+	{
+		static_assert(capacity() >= sizeof(_ValueT), "_ValueT is too big to be stored in static_any_t");
+		return std::hash<static_any_type_id_t>{}(detail::static_any::hash_bytes(__buff.data(), sizeof(_ValueT)));
+	}
+
+	template <class _ValueT>
+	bool equals(const static_any_t& another) const
+	{
+		static_assert(capacity() >= sizeof(_ValueT), "_ValueT is too big to be stored in static_any_t");
+		return std::memcmp(__buff.data(), another.__buff.data(), sizeof(_ValueT)) == 0;
+	}
+
+private:
+	template <class _ValueT>
+	STATIC_ANY_CONSTEXPR_T void copy(_ValueT&& t)
+	{
+		using NonConstT = std::remove_cv_t<std::remove_reference_t<_ValueT>>;
+
+		static_assert(detail::static_any::is_trivially_copyable<NonConstT>::value, "_ValueT is not trivially copyable");
+
+		static_assert(capacity() >= sizeof(_ValueT), "_ValueT is too big to be copied to static_any");
+		static_assert(alignment() >= alignof(NonConstT), "_ValueT is over-aligned for static_any");
+
+#if defined(STATIC_ANY_HAS_CONSTEXPR_T)
+		if (std::is_constant_evaluated())
+		{
+			const auto bytes = std::bit_cast<std::array<char, sizeof(NonConstT)>>(t);
+			__buff = {};
+			for (size_type i = 0; i < bytes.size(); ++i)
+				__buff[i] = bytes[i];
+			return;
+		}
+#endif
+
+		std::memcpy(__buff.data(), reinterpret_cast<char*>(&t), sizeof(_ValueT));
+	}
+
+	alignas(_Align) std::array<char, _N> __buff;
+};
+
+// static_any_t<_N, _Align> followed by the type id of the stored value. It stays trivially copyable, so that
+// arrays of it can be copied with a memcpy, or shared between processes -- see any_wire.hpp. The ids are the same
+// in all the processes built with the same compiler, or can be registered with static_any_type_id. There may be
+// padding around the id, as for static_any_tagged_t<12>, but the padding and the bytes of the buffer after the
+// stored value are zeroed: no uninitialized byte is written to the wire or to a file.
+template <std::size_t _N, std::size_t _Align = detail::static_any::tagged_alignment(_N)>
+class static_any_tagged_t
+{
+	template <class _ValueT>
+	using enable_if_value_t = std::enable_if_t<!std::is_same<std::decay_t<_ValueT>, static_any_tagged_t>::value>;
+
+public:
+	using size_type = std::size_t;
+
+	static constexpr size_type capacity() { return _N; }
+
+	static constexpr size_type alignment() { return _Align; }
+
+	static_any_tagged_t() { clear(); }
+	static_any_tagged_t(const static_any_tagged_t&) = default;
+	static_any_tagged_t& operator=(const static_any_tagged_t&) = default;
+
+	template <class _ValueT, class = enable_if_value_t<_ValueT>>
+	static_any_tagged_t(_ValueT&& t) { assign(std::forward<_ValueT>(t)); }
+
+	template <class _ValueT, class = enable_if_value_t<_ValueT>>
+	static_any_tagged_t& operator=(_ValueT&& t)
+	{
+		assign(std::forward<_ValueT>(t));
+		return *this;
+	}
+
+	void reset() { clear(); }
+
+	template <class _ValueT>
+	bool has() const { return __type_id == type_id_of<std::decay_t<_ValueT>>(); }
+
+	// no check, as for static_any_t
+	template <class _ValueT>
+	_ValueT& get() { assert(has<_ValueT>()); return __value.template get<_ValueT>(); }
+
+	template <class _ValueT>
+	const _ValueT& get() const { assert(has<_ValueT>()); return __value.template get<_ValueT>(); }
+
+	template <class _ValueT>
+	_ValueT* try_get() { return has<_ValueT>() ? &__value.template get<_ValueT>() : nullptr; }
+
+	template <class _ValueT>
+	const _ValueT* try_get() const { return has<_ValueT>() ? &__value.template get<_ValueT>() : nullptr; }
+
+	static_any_type_id_t type_id() const { return __type_id; }
+
+	bool empty() const { return __type_id == static_any_type_id<void>::value; }
+
+private:
+	template <class _ValueT>
+	static constexpr static_any_type_id_t type_id_of() { return detail::static_any::unique_type_id<_ValueT>(); }
+
+	// zeroes the whole object, padding included
+	void clear()
+	{
+		std::memset(static_cast<void*>(this), 0, sizeof(*this));
+		__type_id = static_any_type_id<void>::value;
+	}
+
+	template <class _ValueT>
+	void assign(_ValueT&& t)
+	{
+		clear();
+		__value = std::forward<_ValueT>(t);
+		__type_id = type_id_of<std::decay_t<_ValueT>>();
+	}
+
+	static_any_t<_N, _Align> __value;
+	static_any_type_id_t __type_id;
+};
+
+#if defined(STATIC_ANY_INSTRUMENTATION)
+
+// Counters of a stored type since the start of the program, or the last static_any_reset_stats().
+struct static_any_stats
+{
+	const static_any_type_info& type;
+	std::uint64_t copies;
+	std::uint64_t moves;
+	std::uint64_t destroys;
+	// temporary copies made by the assignments with strong guarantee
+	std::uint64_t backups;
+	// type checks which could not be resolved by comparing vtables, and fell back to type_id or std::type_info
+	std::uint64_t slow_type_checks;
+	std::uint64_t failed_casts;
+};
+
+// calls f with the static_any_stats of each type which has been counted
+template <class _F>
+inline void static_any_for_each_stats(_F&& f)
+{
+	for (const detail::static_any::type_stats* stats = detail::static_any::stats_registry().load(std::memory_order_acquire);
+		 stats != nullptr;
+		 stats = stats->next)
+	{
+		const static_any_stats snapshot =
+		{
+			*stats->type_info,
+			stats->copies.load(std::memory_order_relaxed),
+			stats->moves.load(std::memory_order_relaxed),
+			stats->destroys.load(std::memory_order_relaxed),
+			stats->backups.load(std::memory_order_relaxed),
+			stats->slow_type_checks.load(std::memory_order_relaxed),
+			stats->failed_casts.load(std::memory_order_relaxed)
+		};
+		f(snapshot);
+	}
+}
+
+inline void static_any_reset_stats()
+{
+	for (detail::static_any::type_stats* stats = detail::static_any::stats_registry().load(std::memory_order_acquire);
+		 stats != nullptr;
+		 stats = stats->next)
+	{
+		stats->copies = 0;
+		stats->moves = 0;
+		stats->destroys = 0;
+		stats->backups = 0;
+		stats->slow_type_checks = 0;
+		stats->failed_casts = 0;
+	}
+}
+
+// one line per type, with the mangled type name
+inline void static_any_dump_stats(std::FILE* out = stderr)
+{
+	std::fprintf(out, "%-40s %12s %12s %12s %12s %12s %12s\n", "type", "copies", "moves", "destroys", "backups", "slow checks", "failed casts");
+
+	static_any_for_each_stats([out](const static_any_stats& stats)
+	{
+		std::fprintf(out, "%-40s %12llu %12llu %12llu %12llu %12llu %12llu\n",
+			stats.type.name(),
+			static_cast<unsigned long long>(stats.copies),
+			static_cast<unsigned long long>(stats.moves),
+			static_cast<unsigned long long>(stats.destroys),
+			static_cast<unsigned long long>(stats.backups),
+			static_cast<unsigned long long>(stats.slow_type_checks),
+			static_cast<unsigned long long>(stats.failed_casts));
+	});
+}
+
+#endif
+
+// Explicit instantiation of the members of static_any<_N, _Align> and static_unique_any<_N, _Align> which are not
+// templates, so that they are compiled once in the program instead of in every translation unit using them. A
+// project declares them with STATIC_ANY_EXTERN_TEMPLATE(32) in a common header, and instantiates them with
+// STATIC_ANY_INSTANTIATE(32) in one of its source files. With STATIC_ANY_EXTERN_COMMON_SIZES defined, the
+// sizes 8, 16, 32 and 64 with the default alignment are declared here, and STATIC_ANY_INSTANTIATE_COMMON_SIZES()
+// instantiates them.
+#define STATIC_ANY_EXTERN_TEMPLATE(...) \
+	extern template class static_any<__VA_ARGS__>; \
+	extern template class static_unique_any<__VA_ARGS__>
+
+#define STATIC_ANY_INSTANTIATE(...) \
+	template class static_any<__VA_ARGS__>; \
+	template class static_unique_any<__VA_ARGS__>
+
+#define STATIC_ANY_INSTANTIATE_COMMON_SIZES() \
+	STATIC_ANY_INSTANTIATE(8); \
+	STATIC_ANY_INSTANTIATE(16); \
+	STATIC_ANY_INSTANTIATE(32); \
+	STATIC_ANY_INSTANTIATE(64)
+
+#if defined(STATIC_ANY_EXTERN_COMMON_SIZES)
+STATIC_ANY_EXTERN_TEMPLATE(8);
+STATIC_ANY_EXTERN_TEMPLATE(16);
+STATIC_ANY_EXTERN_TEMPLATE(32);
+STATIC_ANY_EXTERN_TEMPLATE(64);
+#endif
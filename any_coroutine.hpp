@@ -0,0 +1,286 @@
+#pragma once
+
+#include "any_core.hpp"
+
+#if STATIC_ANY_CPLUSPLUS < 202002L || !defined(__has_include)
+# error "any_coroutine.hpp needs C++20 coroutines"
+#elif !__has_include(<coroutine>)
+# error "any_coroutine.hpp needs C++20 coroutines"
+#endif
+
+#include <atomic>
+#include <coroutine>
+#include <exception>
+
+namespace detail { namespace static_any {
+
+// Moves the value, or rethrows the exception, out of a static_any and its exception_ptr, through f, and leaves
+// them empty whatever happens.
+template <class _Any, class _F>
+inline decltype(auto) take_result(_Any& value, std::exception_ptr& error, _F&& f)
+{
+	struct reset_guard
+	{
+		~reset_guard() { value.reset(); }
+
+		_Any& value;
+	} guard{value};
+
+	if (error)
+		std::rethrow_exception(std::exchange(error, nullptr));
+
+	return f(value);
+}
+
+}}
+
+// Single value passed from a producer to a consumer coroutine, stored in place in the channel: there is no
+// allocation, whatever the type of the value. The consumer co_awaits the channel -- or receive<T>(), which gets
+// the value with a single vtable comparison -- and is resumed by emplace() on the thread of the producer, or not
+// suspended if the value is already there. Once received, the channel is empty and can carry the next value.
+// One value at a time: the producer has to wait for the value to be received before sending another one.
+template <std::size_t _N, std::size_t _Align = detail::static_any::default_alignment>
+class static_any_channel
+{
+public:
+	using value_type = static_any<_N, _Align>;
+
+	static_any_channel() = default;
+	~static_any_channel() { assert(!waiting()); }
+
+	static_any_channel(const static_any_channel&) = delete;
+	static_any_channel& operator=(const static_any_channel&) = delete;
+
+	// Constructs the value in place, then resumes the waiting consumer. If the constructor throws, the exception
+	// is propagated to the producer and the consumer keeps waiting.
+	template <class _T, class... Args>
+	void emplace(Args&&... args);
+
+	template <class _T>
+	void send(_T&& t) { emplace<std::decay_t<_T>>(std::forward<_T>(t)); }
+
+	// rethrown in the consumer
+	void set_exception(std::exception_ptr error);
+
+	// a value or an exception is waiting to be received
+	bool ready() const { return __state.load(std::memory_order_acquire) == this; }
+
+	// a consumer is suspended on the channel
+	bool waiting() const
+	{
+		const void* state = __state.load(std::memory_order_acquire);
+		return state != nullptr && state != this;
+	}
+
+	// co_await channel: the value, moved out of the channel
+	class awaiter;
+	awaiter operator co_await() { return awaiter(*this); }
+
+	// co_await channel.receive<T>(): the T, moved out of the channel. Throws bad_any_cast if the value is not a T,
+	// the channel being emptied anyway.
+	template <class _T>
+	class typed_awaiter;
+
+	template <class _T>
+	typed_awaiter<_T> receive() { return typed_awaiter<_T>(*this); }
+
+private:
+	void publish();
+
+	bool suspend(std::coroutine_handle<> consumer);
+
+	template <class _F>
+	decltype(auto) take(_F&& f);
+
+	value_type __value;
+	std::exception_ptr __error;
+	// nullptr when empty, this when ready, or the address of the suspended consumer
+	std::atomic<void*> __state{nullptr};
+};
+
+template <std::size_t _N, std::size_t _Align>
+class static_any_channel<_N, _Align>::awaiter
+{
+public:
+	explicit awaiter(static_any_channel& channel) : __channel(channel) {}
+
+	bool await_ready() const { return __channel.ready(); }
+
+	bool await_suspend(std::coroutine_handle<> consumer) { return __channel.suspend(consumer); }
+
+	value_type await_resume() { return __channel.take([](value_type& value) { return value_type(std::move(value)); }); }
+
+private:
+	static_any_channel& __channel;
+};
+
+template <std::size_t _N, std::size_t _Align>
+template <class _T>
+class static_any_channel<_N, _Align>::typed_awaiter
+{
+public:
+	explicit typed_awaiter(static_any_channel& channel) : __channel(channel) {}
+
+	bool await_ready() const { return __channel.ready(); }
+
+	bool await_suspend(std::coroutine_handle<> consumer) { return __channel.suspend(consumer); }
+
+	_T await_resume() { return __channel.take([](value_type& value) { return _T(std::move(value.template get<_T>())); }); }
+
+private:
+	static_any_channel& __channel;
+};
+
+template <std::size_t _N, std::size_t _Align>
+template <class _T, class... Args>
+void static_any_channel<_N, _Align>::emplace(Args&&... args)
+{
+	assert(!ready());
+	__value.template emplace<_T>(std::forward<Args>(args)...);
+	publish();
+}
+
+template <std::size_t _N, std::size_t _Align>
+void static_any_channel<_N, _Align>::set_exception(std::exception_ptr error)
+{
+	assert(!ready());
+	__error = std::move(error);
+	publish();
+}
+
+template <std::size_t _N, std::size_t _Align>
+void static_any_channel<_N, _Align>::publish()
+{
+	void* consumer = __state.exchange(this, std::memory_order_acq_rel);
+	if (consumer != nullptr)
+		std::coroutine_handle<>::from_address(consumer).resume();
+}
+
+template <std::size_t _N, std::size_t _Align>
+bool static_any_channel<_N, _Align>::suspend(std::coroutine_handle<> consumer)
+{
+	// fails if the value was published since await_ready: the consumer goes on without suspending
+	void* expected = nullptr;
+	return __state.compare_exchange_strong(expected, consumer.address(), std::memory_order_acq_rel, std::memory_order_acquire);
+}
+
+template <std::size_t _N, std::size_t _Align>
+template <class _F>
+decltype(auto) static_any_channel<_N, _Align>::take(_F&& f)
+{
+	struct empty_guard
+	{
+		~empty_guard() { state.store(nullptr, std::memory_order_release); }
+
+		std::atomic<void*>& state;
+	} guard{__state};
+
+	return detail::static_any::take_result(__value, __error, std::forward<_F>(f));
+}
+
+// Lazy coroutine returning a static_any<_N, _Align>: the value given to co_return is emplaced in the promise, in
+// the coroutine frame, and moved out by the co_await of the future. The coroutine starts when awaited, and
+// resumes its awaiter once it returns, without going through a scheduler.
+template <std::size_t _N, std::size_t _Align = detail::static_any::default_alignment>
+class static_any_future
+{
+public:
+	using value_type = static_any<_N, _Align>;
+
+	class promise_type;
+	class awaiter;
+
+	static_any_future(static_any_future&& another) noexcept : __coroutine(std::exchange(another.__coroutine, nullptr)) {}
+
+	static_any_future& operator=(static_any_future&& another) noexcept
+	{
+		std::swap(__coroutine, another.__coroutine);
+		return *this;
+	}
+
+	~static_any_future()
+	{
+		if (__coroutine)
+			__coroutine.destroy();
+	}
+
+	// the coroutine returned, or threw
+	bool ready() const { return __coroutine && __coroutine.done(); }
+
+	// co_await future: the value, moved out of the frame. A future can only be awaited once.
+	awaiter operator co_await() { assert(__coroutine); return awaiter(__coroutine); }
+
+private:
+	explicit static_any_future(std::coroutine_handle<promise_type> coroutine) : __coroutine(coroutine) {}
+
+	std::coroutine_handle<promise_type> __coroutine;
+};
+
+template <std::size_t _N, std::size_t _Align>
+class static_any_future<_N, _Align>::promise_type
+{
+public:
+	static_any_future get_return_object() { return static_any_future(std::coroutine_handle<promise_type>::from_promise(*this)); }
+
+	std::suspend_always initial_suspend() noexcept { return {}; }
+
+	auto final_suspend() noexcept
+	{
+		struct final_awaiter
+		{
+			bool await_ready() noexcept { return false; }
+
+			std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> coroutine) noexcept
+			{
+				const std::coroutine_handle<> continuation = coroutine.promise().__continuation;
+				return continuation ? continuation : std::noop_coroutine();
+			}
+
+			void await_resume() noexcept {}
+		};
+		return final_awaiter{};
+	}
+
+	template <class _T>
+	void return_value(_T&& t)
+	{
+		if constexpr (std::is_same_v<std::decay_t<_T>, value_type>)
+			__value = std::forward<_T>(t);
+		else
+			__value.template emplace<std::decay_t<_T>>(std::forward<_T>(t));
+	}
+
+	void unhandled_exception() { __error = std::current_exception(); }
+
+private:
+	friend class awaiter;
+
+	value_type __value;
+	std::exception_ptr __error;
+	std::coroutine_handle<> __continuation;
+};
+
+template <std::size_t _N, std::size_t _Align>
+class static_any_future<_N, _Align>::awaiter
+{
+public:
+	explicit awaiter(std::coroutine_handle<promise_type> coroutine) : __coroutine(coroutine) {}
+
+	bool await_ready() const { return __coroutine.done(); }
+
+	// starts the coroutine in place of the awaiter, which is resumed by its final suspension
+	std::coroutine_handle<> await_suspend(std::coroutine_handle<> continuation)
+	{
+		__coroutine.promise().__continuation = continuation;
+		return __coroutine;
+	}
+
+	value_type await_resume()
+	{
+		promise_type& promise = __coroutine.promise();
+		return detail::static_any::take_result(promise.__value, promise.__error, [](value_type& value) { return value_type(std::move(value)); });
+	}
+
+private:
+	std::coroutine_handle<promise_type> __coroutine;
+};
@@ -0,0 +1,157 @@
+#pragma once
+
+#include "any_core.hpp"
+
+#include <functional>
+
+namespace detail { namespace static_any {
+
+template <class... _Ts>
+struct type_list {};
+
+template <class _F, class _R, class _Args, class = void>
+struct is_invocable_r : public std::false_type {};
+
+template <class _F, class _R, class... Args>
+struct is_invocable_r<_F, _R, type_list<Args...>, void_t<decltype(std::declval<_F&>()(std::declval<Args>()...))>> :
+	public std::integral_constant<bool,
+		std::is_void<_R>::value || std::is_convertible<decltype(std::declval<_F&>()(std::declval<Args>()...)), _R>::value>
+{};
+
+}}
+
+template <class _Signature,
+		  std::size_t _N,
+		  std::size_t _Align = detail::static_any::default_alignment>
+class static_function;
+
+// Replacement of std::function storing the callable in place, in a static_any<_N, _Align>: there is no
+// allocation, a callable too big or over-aligned does not build, and a call is a single indirect call.
+// As for static_any, a static_function holding a move-only callable throws bad_any_copy on copy.
+template <class _R, class... Args, std::size_t _N, std::size_t _Align>
+class static_function<_R(Args...), _N, _Align>
+{
+	template <class _F>
+	struct is_static_function : public std::false_type {};
+
+	template <class _Sig, std::size_t _M, std::size_t _AlignM>
+	struct is_static_function<static_function<_Sig, _M, _AlignM>> : public std::true_type {};
+
+	template <class _F>
+	using enable_if_callable_t = std::enable_if_t<
+		!is_static_function<std::decay_t<_F>>::value &&
+		detail::static_any::is_invocable_r<std::decay_t<_F>, _R, detail::static_any::type_list<Args...>>::value>;
+
+public:
+	using result_type = _R;
+	using size_type = std::size_t;
+
+	static_function() = default;
+
+	static_function(std::nullptr_t) {}
+
+	template <class _F, class = enable_if_callable_t<_F>>
+	static_function(_F&& f) :
+		__invoke(&invoke<std::decay_t<_F>>)
+	{
+		// emplaced with the decayed type, so that functions are stored as function pointers
+		__any.template emplace<std::decay_t<_F>>(std::forward<_F>(f));
+	}
+
+	template <class _F, class = enable_if_callable_t<_F>>
+	static_function& operator=(_F&& f);
+
+	static_function& operator=(std::nullptr_t);
+
+	_R operator()(Args... args) const;
+
+	void reset();
+
+	bool empty() const { return __any.empty(); }
+
+	explicit operator bool() const { return !empty(); }
+
+	const static_any_type_info& target_type() const { return __any.type(); }
+
+	// pointer to the callable if it is a _F, nullptr otherwise
+	template <class _F>
+	_F* target() { return __any.template try_get<_F>(); }
+
+	template <class _F>
+	const _F* target() const { return __any.template try_get<_F>(); }
+
+	static constexpr size_type capacity() { return _N; }
+
+private:
+	using invoke_t = _R (*)(void*, Args&&...);
+
+	template <class _F>
+	static _R invoke(void* f, Args&&... args)
+	{
+		return call<_F>(f, std::is_void<_R>{}, std::forward<Args>(args)...);
+	}
+
+	template <class _F>
+	static _R call(void* f, std::true_type /* void */, Args&&... args)
+	{
+		(*static_cast<_F*>(f))(std::forward<Args>(args)...);
+	}
+
+	template <class _F>
+	static _R call(void* f, std::false_type /* void */, Args&&... args)
+	{
+		return (*static_cast<_F*>(f))(std::forward<Args>(args)...);
+	}
+
+	// installed when empty, so that a call does not need to check the callable first
+	static _R invoke_empty(void*, Args&&...)
+	{
+		throw std::bad_function_call();
+	}
+
+	static_any<_N, _Align> __any;
+	invoke_t __invoke = &invoke_empty;
+};
+
+template <class _R, class... Args, std::size_t _N, std::size_t _Align>
+template <class _F, class>
+static_function<_R(Args...), _N, _Align>& static_function<_R(Args...), _N, _Align>::operator=(_F&& f)
+{
+	// strong guarantee of the static_any assignment: the callable is left untouched if the copy throws
+	static_function temp(std::forward<_F>(f));
+	__any = std::move(temp.__any);
+	__invoke = temp.__invoke;
+	return *this;
+}
+
+template <class _R, class... Args, std::size_t _N, std::size_t _Align>
+static_function<_R(Args...), _N, _Align>& static_function<_R(Args...), _N, _Align>::operator=(std::nullptr_t)
+{
+	reset();
+	return *this;
+}
+
+template <class _R, class... Args, std::size_t _N, std::size_t _Align>
+_R static_function<_R(Args...), _N, _Align>::operator()(Args... args) const
+{
+	return __invoke(const_cast<char*>(__any.__buff.data()), std::forward<Args>(args)...);
+}
+
+template <class _R, class... Args, std::size_t _N, std::size_t _Align>
+void static_function<_R(Args...), _N, _Align>::reset()
+{
+	__any.reset();
+	__invoke = &invoke_empty;
+}
+
+template <class _R, class... Args, std::size_t _N, std::size_t _Align>
+inline bool operator==(const static_function<_R(Args...), _N, _Align>& f, std::nullptr_t)
+{
+	return f.empty();
+}
+
+template <class _R, class... Args, std::size_t _N, std::size_t _Align>
+inline bool operator!=(const static_function<_R(Args...), _N, _Align>& f, std::nullptr_t)
+{
+	return !f.empty();
+}
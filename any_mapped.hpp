@@ -0,0 +1,376 @@
+#pragma once
+
+#include "any_wire.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#if defined(_WIN32)
+# if !defined(NOMINMAX)
+#  define NOMINMAX
+# endif
+# if !defined(WIN32_LEAN_AND_MEAN)
+#  define WIN32_LEAN_AND_MEAN
+# endif
+# include <windows.h>
+#else
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
+// File format of mapped_any_array: this header, the type_count distinct type ids of the values, then the values
+// as they lie in memory, aligned on alignment. As with any_wire.hpp, the writer and the readers have to share the
+// architecture and the type ids.
+struct static_any_mapped_header
+{
+	static constexpr std::uint32_t magic_value = 0x53414D41; // "SAMA"
+
+	std::uint32_t magic;
+	std::uint32_t capacity;
+	std::uint32_t alignment;
+	std::uint32_t value_size;
+	std::uint64_t count;
+	std::uint64_t type_count;
+};
+
+enum class static_any_map_mode
+{
+	read_only,
+	// the pages are private to the process: the values can be changed, the file is not
+	copy_on_write
+};
+
+namespace detail { namespace static_any {
+
+// smallest alignment of a mapping, on all the supported platforms
+constexpr std::size_t min_page_size = 4096;
+
+inline std::size_t mapped_values_offset(std::uint64_t type_count, std::size_t align)
+{
+	return align_up(sizeof(static_any_mapped_header) + to_size(type_count) * sizeof(static_any_type_id_t), align);
+}
+
+class file_mapping
+{
+public:
+	file_mapping() = default;
+
+	file_mapping(const char* path, static_any_map_mode mode);
+
+	file_mapping(file_mapping&& another) noexcept :
+		__data(another.__data),
+		__size(another.__size)
+	{
+		another.__data = nullptr;
+		another.__size = 0;
+	}
+
+	file_mapping& operator=(file_mapping&& another) noexcept
+	{
+		std::swap(__data, another.__data);
+		std::swap(__size, another.__size);
+		return *this;
+	}
+
+	~file_mapping() { unmap(); }
+
+	char* data() const { return __data; }
+
+	std::size_t size() const { return __size; }
+
+private:
+	void unmap();
+
+	char* __data = nullptr;
+	std::size_t __size = 0;
+};
+
+#if defined(_WIN32)
+
+inline file_mapping::file_mapping(const char* path, static_any_map_mode mode)
+{
+	const HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		throw std::system_error(static_cast<int>(GetLastError()), std::system_category(), "mapped_any_array: open");
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size))
+	{
+		const DWORD error = GetLastError();
+		CloseHandle(file);
+		throw std::system_error(static_cast<int>(error), std::system_category(), "mapped_any_array: size");
+	}
+
+	if (size.QuadPart == 0)
+	{
+		CloseHandle(file);
+		throw std::runtime_error("mapped_any_array: empty file");
+	}
+
+	const bool cow = mode == static_any_map_mode::copy_on_write;
+	const HANDLE mapping = CreateFileMappingA(file, nullptr, cow ? PAGE_WRITECOPY : PAGE_READONLY, 0, 0, nullptr);
+	const DWORD mapping_error = GetLastError();
+	CloseHandle(file);
+	if (mapping == nullptr)
+		throw std::system_error(static_cast<int>(mapping_error), std::system_category(), "mapped_any_array: mapping");
+
+	void* view = MapViewOfFile(mapping, cow ? FILE_MAP_COPY : FILE_MAP_READ, 0, 0, 0);
+	const DWORD view_error = GetLastError();
+	CloseHandle(mapping);
+	if (view == nullptr)
+		throw std::system_error(static_cast<int>(view_error), std::system_category(), "mapped_any_array: map");
+
+	__data = static_cast<char*>(view);
+	__size = static_cast<std::size_t>(size.QuadPart);
+}
+
+inline void file_mapping::unmap()
+{
+	if (__data != nullptr)
+		UnmapViewOfFile(__data);
+}
+
+#else
+
+inline file_mapping::file_mapping(const char* path, static_any_map_mode mode)
+{
+	const int fd = ::open(path, O_RDONLY);
+	if (fd == -1)
+		throw std::system_error(errno, std::generic_category(), "mapped_any_array: open");
+
+	struct stat status;
+	if (::fstat(fd, &status) == -1)
+	{
+		const int error = errno;
+		::close(fd);
+		throw std::system_error(error, std::generic_category(), "mapped_any_array: stat");
+	}
+
+	if (status.st_size == 0)
+	{
+		::close(fd);
+		throw std::runtime_error("mapped_any_array: empty file");
+	}
+
+	const std::size_t size = static_cast<std::size_t>(status.st_size);
+	const bool cow = mode == static_any_map_mode::copy_on_write;
+
+	// a private mapping only needs the file to be readable, to be written in place
+	void* view = ::mmap(nullptr, size, cow ? PROT_READ | PROT_WRITE : PROT_READ, MAP_PRIVATE, fd, 0);
+	const int error = errno;
+	::close(fd);
+	if (view == MAP_FAILED)
+		throw std::system_error(error, std::generic_category(), "mapped_any_array: mmap");
+
+	__data = static_cast<char*>(view);
+	__size = size;
+}
+
+inline void file_mapping::unmap()
+{
+	if (__data != nullptr)
+		::munmap(__data, __size);
+}
+
+#endif
+
+}}
+
+// Array of static_any_tagged_t<_N, _Align> mapped from a file written by save(): loading it maps the file and
+// checks its header, whatever the number of values, and the values are then read in place from the mapped pages.
+// The type ids of the values are listed in the header, so that a reader can check them all with contains_type()
+// before the first get(). A read-only mapping is shared with the page cache, and its values are only accessed
+// as const; a copy-on-write mapping can be written to through writable_data(), the changes being private to the
+// process and lost when unmapped.
+template <std::size_t _N, std::size_t _Align = detail::static_any::tagged_alignment(_N)>
+class mapped_any_array
+{
+	static_assert(_Align <= detail::static_any::min_page_size, "_Align is too big for a mapping");
+
+public:
+	using value_type = static_any_tagged_t<_N, _Align>;
+	using size_type = std::size_t;
+	using const_iterator = const value_type*;
+	// the values are written to through writable_data() only
+	using iterator = const_iterator;
+
+	static_assert(detail::static_any::is_trivially_copyable<value_type>::value, "value_type has to be trivially copyable");
+
+	static constexpr size_type capacity() { return _N; }
+
+	static constexpr size_type alignment() { return _Align; }
+
+	// Writes the header, the type ids and the count values to path, replacing the file. Throws std::system_error.
+	static void save(const char* path, const value_type* values, size_type count);
+
+	mapped_any_array() = default;
+
+	// Throws std::system_error if the file can not be mapped, and std::runtime_error if it does not hold an
+	// array of value_type.
+	explicit mapped_any_array(const char* path, static_any_map_mode mode = static_any_map_mode::read_only);
+
+	mapped_any_array(mapped_any_array&& another) noexcept;
+	mapped_any_array& operator=(mapped_any_array&& another) noexcept;
+
+	mapped_any_array(const mapped_any_array&) = delete;
+	mapped_any_array& operator=(const mapped_any_array&) = delete;
+
+	size_type size() const { return __size; }
+
+	bool empty() const { return __size == 0; }
+
+	bool writable() const { return __mode == static_any_map_mode::copy_on_write; }
+
+	const value_type& operator[](size_type i) const { assert(i < size()); return __values[i]; }
+
+	template <class _ValueT>
+	bool has(size_type i) const { return (*this)[i].template has<_ValueT>(); }
+
+	// no check, as for static_any_tagged_t
+	template <class _ValueT>
+	const _ValueT& get(size_type i) const { return (*this)[i].template get<_ValueT>(); }
+
+	template <class _ValueT>
+	const _ValueT* try_get(size_type i) const { return (*this)[i].template try_get<_ValueT>(); }
+
+	// distinct type ids of the values, sorted
+	const static_any_type_id_t* type_ids() const { return __type_ids; }
+
+	size_type type_count() const { return __type_count; }
+
+	template <class _ValueT>
+	bool contains_type() const { return std::binary_search(__type_ids, __type_ids + __type_count, detail::static_any::unique_type_id<_ValueT>()); }
+
+	const value_type* data() const { return __values; }
+
+	// Throws std::logic_error if the mapping is read-only: its pages are protected, and writing to them crashes.
+	value_type* writable_data();
+
+	const_iterator begin() const { return __values; }
+	const_iterator end() const { return __values + __size; }
+
+private:
+	detail::static_any::file_mapping __mapping;
+	static_any_map_mode __mode = static_any_map_mode::read_only;
+	const static_any_type_id_t* __type_ids = nullptr;
+	size_type __type_count = 0;
+	value_type* __values = nullptr;
+	size_type __size = 0;
+};
+
+template <std::size_t _N, std::size_t _Align>
+typename mapped_any_array<_N, _Align>::value_type* mapped_any_array<_N, _Align>::writable_data()
+{
+	if (!writable())
+		throw std::logic_error("mapped_any_array: the mapping is read-only");
+	return __values;
+}
+
+template <std::size_t _N, std::size_t _Align>
+void mapped_any_array<_N, _Align>::save(const char* path, const value_type* values, size_type count)
+{
+	std::vector<static_any_type_id_t> type_ids(count);
+	for (size_type i = 0; i < count; ++i)
+		type_ids[i] = values[i].type_id();
+
+	std::sort(type_ids.begin(), type_ids.end());
+	type_ids.erase(std::unique(type_ids.begin(), type_ids.end()), type_ids.end());
+
+	static_any_mapped_header header = {};
+	header.magic = static_any_mapped_header::magic_value;
+	header.capacity = static_cast<std::uint32_t>(_N);
+	header.alignment = static_cast<std::uint32_t>(_Align);
+	header.value_size = static_cast<std::uint32_t>(sizeof(value_type));
+	header.count = count;
+	header.type_count = type_ids.size();
+
+	const std::size_t values_offset = detail::static_any::mapped_values_offset(header.type_count, _Align);
+	const std::vector<char> padding(values_offset - sizeof(header) - type_ids.size() * sizeof(static_any_type_id_t));
+
+	std::FILE* file = std::fopen(path, "wb");
+	if (file == nullptr)
+		throw std::system_error(errno, std::generic_category(), "mapped_any_array: open");
+
+	// the empty parts may have no storage
+	const auto write = [file](const void* data, std::size_t size)
+	{
+		return size == 0 || std::fwrite(data, 1, size, file) == size;
+	};
+
+	const bool written =
+		write(&header, sizeof(header)) &&
+		write(type_ids.data(), type_ids.size() * sizeof(static_any_type_id_t)) &&
+		write(padding.data(), padding.size()) &&
+		write(values, count * sizeof(value_type));
+	const int error = errno;
+
+	if (std::fclose(file) != 0 || !written)
+		throw std::system_error(written ? errno : error, std::generic_category(), "mapped_any_array: write");
+}
+
+template <std::size_t _N, std::size_t _Align>
+mapped_any_array<_N, _Align>::mapped_any_array(const char* path, static_any_map_mode mode) :
+	__mapping(path, mode),
+	__mode(mode)
+{
+	const std::size_t file_size = __mapping.size();
+	if (file_size < sizeof(static_any_mapped_header))
+		throw std::runtime_error("mapped_any_array: truncated header");
+
+	static_any_mapped_header header;
+	std::memcpy(&header, __mapping.data(), sizeof(header));
+
+	if (header.magic != static_any_mapped_header::magic_value ||
+		header.capacity != _N ||
+		header.alignment != _Align ||
+		header.value_size != sizeof(value_type))
+		throw std::runtime_error("mapped_any_array: the file does not hold this type of array");
+
+	// the types of the values can not outnumber them
+	if (header.type_count > header.count ||
+		header.count > (file_size - sizeof(header)) / sizeof(value_type))
+		throw std::runtime_error("mapped_any_array: truncated file");
+
+	const std::size_t values_offset = detail::static_any::mapped_values_offset(header.type_count, _Align);
+	if (values_offset > file_size || header.count > (file_size - values_offset) / sizeof(value_type))
+		throw std::runtime_error("mapped_any_array: truncated file");
+
+	__type_ids = reinterpret_cast<const static_any_type_id_t*>(__mapping.data() + sizeof(header));
+	__type_count = detail::static_any::to_size(header.type_count);
+	__values = reinterpret_cast<value_type*>(__mapping.data() + values_offset);
+	__size = detail::static_any::to_size(header.count);
+}
+
+template <std::size_t _N, std::size_t _Align>
+mapped_any_array<_N, _Align>::mapped_any_array(mapped_any_array&& another) noexcept :
+	__mapping(std::move(another.__mapping)),
+	__mode(another.__mode),
+	__type_ids(another.__type_ids),
+	__type_count(another.__type_count),
+	__values(another.__values),
+	__size(another.__size)
+{
+	another.__type_ids = nullptr;
+	another.__type_count = 0;
+	another.__values = nullptr;
+	another.__size = 0;
+}
+
+template <std::size_t _N, std::size_t _Align>
+mapped_any_array<_N, _Align>& mapped_any_array<_N, _Align>::operator=(mapped_any_array&& another) noexcept
+{
+	std::swap(__mapping, another.__mapping);
+	std::swap(__mode, another.__mode);
+	std::swap(__type_ids, another.__type_ids);
+	std::swap(__type_count, another.__type_count);
+	std::swap(__values, another.__values);
+	std::swap(__size, another.__size);
+	return *this;
+}
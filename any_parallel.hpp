@@ -0,0 +1,276 @@
+#pragma once
+
+#include "any_core.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace detail { namespace static_any {
+
+// share of the tasks of a thread, taken from the front by its owner and stolen from the back by the others
+struct task_range
+{
+	std::mutex mutex;
+	std::size_t begin = 0;
+	std::size_t end = 0;
+};
+
+inline bool take_task(task_range& range, bool steal, std::size_t& task)
+{
+	std::lock_guard<std::mutex> lock(range.mutex);
+	if (range.begin == range.end)
+		return false;
+
+	task = steal ? --range.end : range.begin++;
+	return true;
+}
+
+// Runs f(task) for each task of [0, count) on up to threads threads, the calling one included. Each thread starts
+// with a contiguous share of the tasks, then steals the last tasks of the others once its own share is done.
+// The first exception thrown by a task stops the threads before their next task, and is rethrown.
+template <class _F>
+inline void run_work_stealing(std::size_t count, std::size_t threads, _F&& f)
+{
+	threads = std::max<std::size_t>(1, std::min(threads, count));
+	if (count == 0)
+		return;
+
+	std::unique_ptr<task_range[]> ranges(new task_range[threads]);
+	for (std::size_t i = 0; i < threads; ++i)
+	{
+		ranges[i].begin = count * i / threads;
+		ranges[i].end = count * (i + 1) / threads;
+	}
+
+	std::atomic<bool> failed{false};
+	std::exception_ptr error;
+	std::mutex error_mutex;
+
+	auto worker = [&](std::size_t self)
+	{
+		std::size_t task = 0;
+
+		// victim 0 is the own share of the thread: once a share is empty, it stays empty
+		for (std::size_t victim = 0; victim < threads && !failed.load(std::memory_order_relaxed); )
+		{
+			if (!take_task(ranges[(self + victim) % threads], victim != 0, task))
+			{
+				++victim;
+				continue;
+			}
+
+			try
+			{
+				f(task);
+			}
+			catch(...)
+			{
+				std::lock_guard<std::mutex> lock(error_mutex);
+				if (!error)
+					error = std::current_exception();
+				failed.store(true, std::memory_order_relaxed);
+			}
+		}
+	};
+
+	std::vector<std::thread> workers;
+	workers.reserve(threads - 1);
+
+	try
+	{
+		for (std::size_t i = 1; i < threads; ++i)
+			workers.emplace_back(worker, i);
+	}
+	catch(...)
+	{
+		failed.store(true, std::memory_order_relaxed);
+		for (std::thread& t : workers)
+			t.join();
+		throw;
+	}
+
+	worker(0);
+
+	for (std::thread& t : workers)
+		t.join();
+
+	if (error)
+		std::rethrow_exception(error);
+}
+
+template <class _T>
+struct typed_array
+{
+	static void* allocate(std::size_t count) { return std::allocator<_T>().allocate(count); }
+
+	static void deallocate(void* values, std::size_t count) { std::allocator<_T>().deallocate(static_cast<_T*>(values), count); }
+
+	static void destroy(void* values, std::size_t first, std::size_t last)
+	{
+		for (std::size_t i = first; i < last; ++i)
+			static_cast<_T*>(values)[i].~_T();
+	}
+
+	template <class _Handler>
+	static void call(_Handler& handler, void* values, std::size_t count) { handler(static_cast<_T*>(values), count); }
+};
+
+// The values of a range of static_any holding one of _Ts, moved to one array per type. offsets holds, for each
+// chunk of the range and each type, the position in the array of the type of the first value of the chunk.
+template <class... _Ts>
+struct type_streams
+{
+	static constexpr std::size_t types = sizeof...(_Ts);
+
+	explicit type_streams(std::size_t chunk_count) :
+		chunks(chunk_count),
+		offsets(chunk_count * types),
+		moved(chunk_count)
+	{}
+
+	~type_streams()
+	{
+		using destroy_t = void (*)(void*, std::size_t, std::size_t);
+		using deallocate_t = void (*)(void*, std::size_t);
+		const destroy_t destroy[] = { &typed_array<_Ts>::destroy... };
+		const deallocate_t deallocate[] = { &typed_array<_Ts>::deallocate... };
+
+		for (std::size_t chunk = 0; chunk < chunks; ++chunk)
+			if (moved[chunk])
+				for (std::size_t type = 0; type < types; ++type)
+					destroy[type](values[type], offset(chunk, type), offset(chunk + 1, type));
+
+		for (std::size_t type = 0; type < types; ++type)
+			if (values[type] != nullptr)
+				deallocate[type](values[type], totals[type]);
+	}
+
+	type_streams(const type_streams&) = delete;
+	type_streams& operator=(const type_streams&) = delete;
+
+	// turns the counts of the chunks into offsets, and allocates the arrays
+	void allocate()
+	{
+		using allocate_t = void* (*)(std::size_t);
+		const allocate_t allocate[] = { &typed_array<_Ts>::allocate... };
+
+		for (std::size_t chunk = 0; chunk < chunks; ++chunk)
+		{
+			for (std::size_t type = 0; type < types; ++type)
+			{
+				const std::size_t count = offsets[chunk * types + type];
+				offsets[chunk * types + type] = totals[type];
+				totals[type] += count;
+			}
+		}
+
+		for (std::size_t type = 0; type < types; ++type)
+			if (totals[type] != 0)
+				values[type] = allocate[type](totals[type]);
+	}
+
+	std::size_t offset(std::size_t chunk, std::size_t type) const
+	{
+		return chunk == chunks ? totals[type] : offsets[chunk * types + type];
+	}
+
+	const std::size_t chunks;
+	std::vector<std::size_t> offsets;
+	// set once all the values of a chunk are moved: each chunk has its own byte, written by a single thread
+	std::vector<char> moved;
+	std::array<std::size_t, types> totals{};
+	std::array<void*, types> values{};
+};
+
+template <class... _Ts>
+constexpr std::size_t type_streams<_Ts...>::types;
+
+}}
+
+// Moves the values of [first, last) holding one of _Ts into one contiguous array per type, keeping their order,
+// then calls handler(values, count) -- values being a _T* -- for each type found. The range is split in chunks of
+// chunk_size values, which threads count then move with work stealing, and the handlers of the types are called
+// concurrently. The values moved out are left in their moved-from state in the range, the others are untouched.
+// The arrays are destroyed on return, or if an exception is thrown by a move or a handler, which is rethrown.
+template <class... _Ts,
+		  std::size_t _S,
+		  std::size_t _A,
+		  class _Handler>
+inline void parallel_process_by_type(static_any<_S, _A>* first,
+									 static_any<_S, _A>* last,
+									 _Handler&& handler,
+									 std::size_t threads = std::thread::hardware_concurrency(),
+									 std::size_t chunk_size = 4096)
+{
+	static_assert(sizeof...(_Ts) > 0, "parallel_process_by_type needs at least one type");
+
+	using streams_t = detail::static_any::type_streams<_Ts...>;
+
+	const std::size_t size = static_cast<std::size_t>(last - first);
+	chunk_size = std::max<std::size_t>(1, chunk_size);
+	threads = std::max<std::size_t>(1, threads);
+
+	streams_t streams((size + chunk_size - 1) / chunk_size);
+
+	const auto chunk_begin = [&](std::size_t chunk) { return first + chunk * chunk_size; };
+	const auto chunk_end = [&](std::size_t chunk) { return first + std::min(size, (chunk + 1) * chunk_size); };
+
+	detail::static_any::run_work_stealing(streams.chunks, threads, [&](std::size_t chunk)
+	{
+		std::size_t* counts = &streams.offsets[chunk * streams_t::types];
+
+		for (static_any<_S, _A>* it = chunk_begin(chunk); it != chunk_end(chunk); ++it)
+			visit<_Ts...>(*it, [counts](auto& value)
+			{
+				++counts[detail::static_any::index_of<std::decay_t<decltype(value)>, _Ts...>::value];
+			});
+	});
+
+	streams.allocate();
+
+	detail::static_any::run_work_stealing(streams.chunks, threads, [&](std::size_t chunk)
+	{
+		std::array<std::size_t, streams_t::types> next;
+		for (std::size_t type = 0; type < streams_t::types; ++type)
+			next[type] = streams.offset(chunk, type);
+
+		try
+		{
+			for (static_any<_S, _A>* it = chunk_begin(chunk); it != chunk_end(chunk); ++it)
+				visit<_Ts...>(*it, [&](auto& value)
+				{
+					using value_type = std::decay_t<decltype(value)>;
+					const std::size_t type = detail::static_any::index_of<value_type, _Ts...>::value;
+
+					new(static_cast<value_type*>(streams.values[type]) + next[type]) value_type(std::move(value));
+					++next[type];
+				});
+		}
+		catch(...)
+		{
+			using destroy_t = void (*)(void*, std::size_t, std::size_t);
+			const destroy_t destroy[] = { &detail::static_any::typed_array<_Ts>::destroy... };
+
+			for (std::size_t type = 0; type < streams_t::types; ++type)
+				destroy[type](streams.values[type], streams.offset(chunk, type), next[type]);
+			throw;
+		}
+
+		streams.moved[chunk] = 1;
+	});
+
+	using call_t = void (*)(std::remove_reference_t<_Handler>&, void*, std::size_t);
+	const call_t calls[] = { &detail::static_any::typed_array<_Ts>::template call<std::remove_reference_t<_Handler>>... };
+
+	detail::static_any::run_work_stealing(streams_t::types, threads, [&](std::size_t type)
+	{
+		if (streams.totals[type] != 0)
+			calls[type](handler, streams.values[type], streams.totals[type]);
+	});
+}
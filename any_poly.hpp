@@ -0,0 +1,110 @@
+#pragma once
+
+#include "any_core.hpp"
+
+#include <cstddef>
+
+// Polymorphic value stored in place: holds any type deriving from _Interface and fitting in a
+// static_any<_N, _Align>, and gives access to it through a _Interface pointer. The offset of the _Interface
+// base is computed once, on assignment, hence a call is a single virtual call. _Interface does not need
+// a virtual destructor, the stored type is destroyed through the static_any vtable.
+template <class _Interface,
+		  std::size_t _N,
+		  std::size_t _Align = detail::static_any::default_alignment>
+class static_poly
+{
+	template <class _T>
+	struct is_static_poly : public std::false_type {};
+
+	template <class _I, std::size_t _M, std::size_t _AlignM>
+	struct is_static_poly<static_poly<_I, _M, _AlignM>> : public std::true_type {};
+
+	// a public and unambiguous base only: std::is_base_of also accepts the private and the ambiguous ones, which
+	// the conversion to the interface pointer then rejects
+	template <class _T>
+	using is_derived = std::is_convertible<_T*, _Interface*>;
+
+	template <class _T>
+	using enable_if_derived_t = std::enable_if_t<
+		!is_static_poly<std::decay_t<_T>>::value &&
+		is_derived<std::decay_t<_T>>::value>;
+
+public:
+	using interface_type = _Interface;
+	using size_type = std::size_t;
+
+	static_poly() = default;
+
+	template <class _T, class = enable_if_derived_t<_T>>
+	static_poly(_T&& t);
+
+	template <class _T, class = enable_if_derived_t<_T>>
+	static_poly& operator=(_T&& t);
+
+	template <class _T, class... Args>
+	void emplace(Args&&... args);
+
+	void reset() { __any.reset(); }
+
+	bool empty() const { return __any.empty(); }
+
+	explicit operator bool() const { return !empty(); }
+
+	// nullptr if empty
+	_Interface* get() { return empty() ? nullptr : interface(); }
+	const _Interface* get() const { return empty() ? nullptr : interface(); }
+
+	_Interface* operator->() { assert(!empty()); return interface(); }
+	const _Interface* operator->() const { assert(!empty()); return interface(); }
+
+	_Interface& operator*() { assert(!empty()); return *interface(); }
+	const _Interface& operator*() const { assert(!empty()); return *interface(); }
+
+	template <class _T>
+	bool has() const { return __any.template has<_T>(); }
+
+	const static_any_type_info& type() const { return __any.type(); }
+
+	static constexpr size_type capacity() { return _N; }
+
+private:
+	template <class _T>
+	static std::ptrdiff_t interface_offset(const _T& t)
+	{
+		const _Interface& base = t;
+		return reinterpret_cast<const char*>(&base) - reinterpret_cast<const char*>(&t);
+	}
+
+	_Interface* interface() { return reinterpret_cast<_Interface*>(__any.__buff.data() + __offset); }
+	const _Interface* interface() const { return reinterpret_cast<const _Interface*>(__any.__buff.data() + __offset); }
+
+	static_any<_N, _Align> __any;
+	std::ptrdiff_t __offset{};
+};
+
+template <class _Interface, std::size_t _N, std::size_t _Align>
+template <class _T, class>
+static_poly<_Interface, _N, _Align>::static_poly(_T&& t) :
+	__any(std::forward<_T>(t))
+{
+	__offset = interface_offset(*reinterpret_cast<const std::decay_t<_T>*>(__any.__buff.data()));
+}
+
+template <class _Interface, std::size_t _N, std::size_t _Align>
+template <class _T, class>
+static_poly<_Interface, _N, _Align>& static_poly<_Interface, _N, _Align>::operator=(_T&& t)
+{
+	__any = std::forward<_T>(t);
+	__offset = interface_offset(*reinterpret_cast<const std::decay_t<_T>*>(__any.__buff.data()));
+	return *this;
+}
+
+template <class _Interface, std::size_t _N, std::size_t _Align>
+template <class _T, class... Args>
+void static_poly<_Interface, _N, _Align>::emplace(Args&&... args)
+{
+	static_assert(is_derived<_T>::value, "_T does not derive publicly and unambiguously from the interface of static_poly");
+
+	__any.template emplace<_T>(std::forward<Args>(args)...);
+	__offset = interface_offset(*reinterpret_cast<const _T*>(__any.__buff.data()));
+}
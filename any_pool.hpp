@@ -0,0 +1,182 @@
+#pragma once
+
+#include "any_range.hpp"
+
+#include <memory>
+#include <vector>
+
+// Pool of static_any<_N, _Align> objects, handed out from pages of contiguous slots allocated through _Alloc.
+// Released slots are recycled, and the pages are only freed by the destructor of the pool: once warm, acquiring
+// and releasing does not allocate. clear() releases all the objects at once, at the end of a request for
+// instance, with one destroy call per run of values of the same type and none for trivial types.
+template <std::size_t _N,
+		  std::size_t _Align = detail::static_any::default_alignment,
+		  class _Alloc = std::allocator<char>>
+class static_any_pool :
+	private std::allocator_traits<_Alloc>::template rebind_alloc<static_any<_N, _Align>>
+{
+	static_assert(_Align <= alignof(std::max_align_t), "_Align is over-aligned for static_any_pool");
+
+public:
+	using value_type = static_any<_N, _Align>;
+	using size_type = std::size_t;
+	using allocator_type = _Alloc;
+
+	explicit static_any_pool(size_type page_size = 256, const allocator_type& alloc = allocator_type());
+
+	~static_any_pool();
+
+	static_any_pool(const static_any_pool&) = delete;
+	static_any_pool& operator=(const static_any_pool&) = delete;
+
+	// an empty static_any, valid until released or until clear() is called
+	value_type* acquire();
+
+	// a static_any holding a _T constructed from args; nothing is acquired if the constructor throws
+	template <class _T, class... Args>
+	value_type* create(Args&&... args);
+
+	// destroys the value and recycles the slot
+	void release(value_type* value);
+
+	// releases all the objects, the pages are kept
+	void clear() noexcept;
+
+	// number of objects acquired and not released
+	size_type live_count() const { return __live_count; }
+
+	// highest live count since the creation of the pool
+	size_type high_water_mark() const { return __high_water_mark; }
+
+	// number of slots allocated
+	size_type capacity() const { return __pages.size() * __page_size; }
+
+	size_type page_size() const { return __page_size; }
+
+	allocator_type get_allocator() const { return allocator_type(get_value_allocator()); }
+
+private:
+	using value_allocator = typename std::allocator_traits<_Alloc>::template rebind_alloc<value_type>;
+	using value_traits = std::allocator_traits<value_allocator>;
+
+	template <class _T>
+	using vector = std::vector<_T, typename std::allocator_traits<_Alloc>::template rebind_alloc<_T>>;
+
+	value_allocator& get_value_allocator() { return *this; }
+	const value_allocator& get_value_allocator() const { return *this; }
+
+	const size_type __page_size;
+
+	// the slots of the pages before __page, and the first __used slots of __page, have been constructed
+	vector<value_type*> __pages;
+	size_type __page = 0;
+	size_type __used = 0;
+
+	vector<value_type*> __free;
+
+	size_type __live_count = 0;
+	size_type __high_water_mark = 0;
+};
+
+template <std::size_t _N, std::size_t _Align, class _Alloc>
+static_any_pool<_N, _Align, _Alloc>::static_any_pool(size_type page_size, const allocator_type& alloc) :
+	value_allocator(alloc),
+	__page_size(page_size),
+	__pages(alloc),
+	__free(alloc)
+{
+	assert(page_size != 0);
+}
+
+template <std::size_t _N, std::size_t _Align, class _Alloc>
+static_any_pool<_N, _Align, _Alloc>::~static_any_pool()
+{
+	clear();
+
+	for (value_type* page : __pages)
+		value_traits::deallocate(get_value_allocator(), page, __page_size);
+}
+
+template <std::size_t _N, std::size_t _Align, class _Alloc>
+typename static_any_pool<_N, _Align, _Alloc>::value_type* static_any_pool<_N, _Align, _Alloc>::acquire()
+{
+	value_type* value;
+
+	if (!__free.empty())
+	{
+		value = __free.back();
+		__free.pop_back();
+	}
+	else
+	{
+		if (__page == __pages.size() || __used == __page_size)
+		{
+			if (__page != __pages.size())
+			{
+				++__page;
+				__used = 0;
+			}
+
+			if (__page == __pages.size())
+			{
+				// reserved first, so that a failure cannot leak the page
+				__pages.reserve(__pages.size() + 1);
+				__free.reserve(capacity() + __page_size);
+				__pages.push_back(value_traits::allocate(get_value_allocator(), __page_size));
+			}
+		}
+
+		value = new(__pages[__page] + __used) value_type();
+		++__used;
+	}
+
+	++__live_count;
+	__high_water_mark = __live_count > __high_water_mark ? __live_count : __high_water_mark;
+	return value;
+}
+
+template <std::size_t _N, std::size_t _Align, class _Alloc>
+template <class _T, class... Args>
+typename static_any_pool<_N, _Align, _Alloc>::value_type* static_any_pool<_N, _Align, _Alloc>::create(Args&&... args)
+{
+	value_type* value = acquire();
+
+	try
+	{
+		value->template emplace<_T>(std::forward<Args>(args)...);
+	}
+	catch(...)
+	{
+		release(value);
+		throw;
+	}
+
+	return value;
+}
+
+template <std::size_t _N, std::size_t _Align, class _Alloc>
+void static_any_pool<_N, _Align, _Alloc>::release(value_type* value)
+{
+	assert(__live_count != 0);
+
+	// the free list has room for all the slots
+	value->reset();
+	__free.push_back(value);
+	--__live_count;
+}
+
+template <std::size_t _N, std::size_t _Align, class _Alloc>
+void static_any_pool<_N, _Align, _Alloc>::clear() noexcept
+{
+	// the recycled slots are empty: destroy_range skips them
+	for (size_type i = 0; i < __page && i < __pages.size(); ++i)
+		destroy_range(__pages[i], __pages[i] + __page_size);
+
+	if (__page < __pages.size())
+		destroy_range(__pages[__page], __pages[__page] + __used);
+
+	__page = 0;
+	__used = 0;
+	__free.clear();
+	__live_count = 0;
+}
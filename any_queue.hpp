@@ -0,0 +1,396 @@
+#pragma once
+
+#include "any_core.hpp"
+
+#include <atomic>
+#include <memory>
+#include <new>
+
+namespace detail { namespace static_any {
+
+constexpr std::size_t cache_line_size = 64;
+
+constexpr std::size_t round_up_pow2(std::size_t n)
+{
+	std::size_t pow2 = 1;
+	while (pow2 < n)
+		pow2 *= 2;
+	return pow2;
+}
+
+// An index owned by one side of a queue, preceded by a cache line of padding: whatever the alignment of
+// the queue, it never shares a cache line with the fields before it. The queues are not over-aligned
+// classes, as new does not honour over-alignment before C++17.
+struct padded_index
+{
+	char padding[cache_line_size];
+	std::atomic<std::size_t> value{0};
+	// last value seen of the index of the other side, to avoid reading its cache line on every operation
+	std::size_t cached{0};
+};
+
+// Array of slots aligned on cache lines, or on the alignment of the slots if it is bigger: the storage is
+// over-allocated and aligned by hand.
+template <class _Slot>
+class slot_array
+{
+	static constexpr std::size_t alignment = alignof(_Slot) > cache_line_size ? alignof(_Slot) : cache_line_size;
+
+public:
+	explicit slot_array(std::size_t count) :
+		__storage(new char[count * sizeof(_Slot) + alignment]),
+		__count(count)
+	{
+		void* ptr = __storage.get();
+		std::size_t space = count * sizeof(_Slot) + alignment;
+		__slots = static_cast<_Slot*>(std::align(alignment, count * sizeof(_Slot), ptr, space));
+
+		for (std::size_t i = 0; i < count; ++i)
+			new(&__slots[i]) _Slot(i);
+	}
+
+	~slot_array()
+	{
+		for (std::size_t i = 0; i < __count; ++i)
+			__slots[i].~_Slot();
+	}
+
+	slot_array(const slot_array&) = delete;
+	slot_array& operator=(const slot_array&) = delete;
+
+	_Slot& operator[](std::size_t i) { return __slots[i]; }
+
+private:
+	std::unique_ptr<char[]> __storage;
+	_Slot* __slots;
+	std::size_t __count;
+};
+
+template <class _Slot>
+constexpr std::size_t slot_array<_Slot>::alignment;
+
+template <class _Queue, class _Slot>
+struct release_guard
+{
+	~release_guard() { queue.release(slot); }
+
+	_Queue& queue;
+	_Slot& slot;
+};
+
+}}
+
+// Bounded lock-free queue of static_any<_N, _Align>, for one producer and one consumer thread. The values are
+// emplaced in place in the slots, and consumed in place or moved out; the slots are padded to cache lines, and
+// each side only reads the index of the other one when its cached value says the queue is full or empty. An
+// empty static_any pushed is popped empty, as in mpsc_any_queue.
+template <std::size_t _N, std::size_t _Align = detail::static_any::default_alignment>
+class spsc_any_queue
+{
+public:
+	using value_type = static_any<_N, _Align>;
+	using size_type = std::size_t;
+
+	// the capacity is rounded up to a power of two
+	explicit spsc_any_queue(size_type capacity);
+
+	spsc_any_queue(const spsc_any_queue&) = delete;
+	spsc_any_queue& operator=(const spsc_any_queue&) = delete;
+
+	// producer side: returns false if the queue is full. If the constructor of _T throws, nothing is pushed.
+	template <class _T, class... Args>
+	bool try_emplace(Args&&... args);
+
+	// pushes a value, or a copy of a static_any that fits
+	template <class _T>
+	bool try_push(_T&& t);
+
+	// consumer side: returns false if the queue is empty
+	bool try_pop(value_type& value);
+
+	// calls f on the value in place -- with visit() for instance --, then destroys it
+	template <class _F>
+	bool try_consume(_F&& f);
+
+	size_type capacity() const { return __mask + 1; }
+
+	// approximate if called while the other side is running
+	bool empty() const { return __head.value.load(std::memory_order_acquire) == __tail.value.load(std::memory_order_acquire); }
+
+private:
+	struct alignas(detail::static_any::cache_line_size) slot
+	{
+		explicit slot(std::size_t) {}
+
+		value_type value;
+	};
+
+	template <class _Construct>
+	bool push_with(_Construct&& construct);
+
+	slot* front();
+	void release(slot& s);
+
+	friend struct detail::static_any::release_guard<spsc_any_queue, slot>;
+
+	detail::static_any::slot_array<slot> __slots;
+	const size_type __mask;
+
+	// the consumer owns __head, the producer __tail
+	detail::static_any::padded_index __head;
+	detail::static_any::padded_index __tail;
+	char __padding[detail::static_any::cache_line_size];
+};
+
+template <std::size_t _N, std::size_t _Align>
+spsc_any_queue<_N, _Align>::spsc_any_queue(size_type capacity) :
+	__slots(detail::static_any::round_up_pow2(capacity)),
+	__mask(detail::static_any::round_up_pow2(capacity) - 1)
+{}
+
+template <std::size_t _N, std::size_t _Align>
+template <class _T, class... Args>
+bool spsc_any_queue<_N, _Align>::try_emplace(Args&&... args)
+{
+	return push_with([&](value_type& value) { value.template emplace<_T>(std::forward<Args>(args)...); });
+}
+
+template <std::size_t _N, std::size_t _Align>
+template <class _T>
+bool spsc_any_queue<_N, _Align>::try_push(_T&& t)
+{
+	return push_with([&t](value_type& value) { value = std::forward<_T>(t); });
+}
+
+template <std::size_t _N, std::size_t _Align>
+template <class _Construct>
+bool spsc_any_queue<_N, _Align>::push_with(_Construct&& construct)
+{
+	const size_type tail = __tail.value.load(std::memory_order_relaxed);
+
+	if (tail - __tail.cached == capacity())
+	{
+		__tail.cached = __head.value.load(std::memory_order_acquire);
+		if (tail - __tail.cached == capacity())
+			return false;
+	}
+
+	construct(__slots[tail & __mask].value);
+	__tail.value.store(tail + 1, std::memory_order_release);
+	return true;
+}
+
+template <std::size_t _N, std::size_t _Align>
+bool spsc_any_queue<_N, _Align>::try_pop(value_type& value)
+{
+	return try_consume([&value](value_type& v) { value = std::move(v); });
+}
+
+template <std::size_t _N, std::size_t _Align>
+template <class _F>
+bool spsc_any_queue<_N, _Align>::try_consume(_F&& f)
+{
+	slot* s = front();
+	if (s == nullptr)
+		return false;
+
+	detail::static_any::release_guard<spsc_any_queue, slot> guard{*this, *s};
+	f(s->value);
+	return true;
+}
+
+template <std::size_t _N, std::size_t _Align>
+typename spsc_any_queue<_N, _Align>::slot* spsc_any_queue<_N, _Align>::front()
+{
+	const size_type head = __head.value.load(std::memory_order_relaxed);
+
+	if (head == __head.cached)
+	{
+		__head.cached = __tail.value.load(std::memory_order_acquire);
+		if (head == __head.cached)
+			return nullptr;
+	}
+
+	return &__slots[head & __mask];
+}
+
+template <std::size_t _N, std::size_t _Align>
+void spsc_any_queue<_N, _Align>::release(slot& s)
+{
+	s.value.reset();
+	__head.value.store(__head.value.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+
+// Bounded lock-free queue of static_any<_N, _Align>, for many producer threads and one consumer thread. Each
+// slot has a sequence number telling whether it is free or holds a value of a given round, so that producers
+// only contend on the claim of a slot. If the constructor of a value throws, its slot is published as not
+// constructed and skipped by the consumer; an empty static_any pushed is popped empty, as in spsc_any_queue.
+template <std::size_t _N, std::size_t _Align = detail::static_any::default_alignment>
+class mpsc_any_queue
+{
+public:
+	using value_type = static_any<_N, _Align>;
+	using size_type = std::size_t;
+
+	// the capacity is rounded up to a power of two
+	explicit mpsc_any_queue(size_type capacity);
+
+	mpsc_any_queue(const mpsc_any_queue&) = delete;
+	mpsc_any_queue& operator=(const mpsc_any_queue&) = delete;
+
+	// producer side, from any thread: returns false if the queue is full
+	template <class _T, class... Args>
+	bool try_emplace(Args&&... args);
+
+	// pushes a value, or a copy of a static_any that fits
+	template <class _T>
+	bool try_push(_T&& t);
+
+	// consumer side, from a single thread: returns false if the queue is empty
+	bool try_pop(value_type& value);
+
+	template <class _F>
+	bool try_consume(_F&& f);
+
+	size_type capacity() const { return __mask + 1; }
+
+private:
+	struct alignas(detail::static_any::cache_line_size) slot
+	{
+		explicit slot(std::size_t index) : sequence(index) {}
+
+		std::atomic<std::size_t> sequence;
+		// false if the constructor of the value threw, the value may be empty either way
+		bool constructed = false;
+		value_type value;
+	};
+
+	struct publish_guard
+	{
+		~publish_guard() { s.sequence.store(position + 1, std::memory_order_release); }
+
+		slot& s;
+		size_type position;
+	};
+
+	template <class _Construct>
+	bool push_with(_Construct&& construct);
+
+	slot* front();
+	void release(slot& s);
+
+	friend struct detail::static_any::release_guard<mpsc_any_queue, slot>;
+
+	detail::static_any::slot_array<slot> __slots;
+	const size_type __mask;
+
+	// the consumer owns __head, the producers share __tail
+	detail::static_any::padded_index __head;
+	detail::static_any::padded_index __tail;
+	char __padding[detail::static_any::cache_line_size];
+};
+
+template <std::size_t _N, std::size_t _Align>
+mpsc_any_queue<_N, _Align>::mpsc_any_queue(size_type capacity) :
+	__slots(detail::static_any::round_up_pow2(capacity)),
+	__mask(detail::static_any::round_up_pow2(capacity) - 1)
+{}
+
+template <std::size_t _N, std::size_t _Align>
+template <class _T, class... Args>
+bool mpsc_any_queue<_N, _Align>::try_emplace(Args&&... args)
+{
+	return push_with([&](value_type& value) { value.template emplace<_T>(std::forward<Args>(args)...); });
+}
+
+template <std::size_t _N, std::size_t _Align>
+template <class _T>
+bool mpsc_any_queue<_N, _Align>::try_push(_T&& t)
+{
+	return push_with([&t](value_type& value) { value = std::forward<_T>(t); });
+}
+
+template <std::size_t _N, std::size_t _Align>
+template <class _Construct>
+bool mpsc_any_queue<_N, _Align>::push_with(_Construct&& construct)
+{
+	size_type position = __tail.value.load(std::memory_order_relaxed);
+	slot* s;
+
+	for (;;)
+	{
+		s = &__slots[position & __mask];
+		const size_type sequence = s->sequence.load(std::memory_order_acquire);
+
+		if (sequence == position)
+		{
+			if (__tail.value.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+				break;
+		}
+		else if (static_cast<std::ptrdiff_t>(sequence - position) < 0)
+		{
+			// the slot still holds the value of the previous round
+			return false;
+		}
+		else
+		{
+			position = __tail.value.load(std::memory_order_relaxed);
+		}
+	}
+
+	// the slot is published even if the constructor throws, the consumer would wait for it otherwise
+	publish_guard guard{*s, position};
+	construct(s->value);
+	s->constructed = true;
+	return true;
+}
+
+template <std::size_t _N, std::size_t _Align>
+bool mpsc_any_queue<_N, _Align>::try_pop(value_type& value)
+{
+	return try_consume([&value](value_type& v) { value = std::move(v); });
+}
+
+template <std::size_t _N, std::size_t _Align>
+template <class _F>
+bool mpsc_any_queue<_N, _Align>::try_consume(_F&& f)
+{
+	slot* s = front();
+	if (s == nullptr)
+		return false;
+
+	detail::static_any::release_guard<mpsc_any_queue, slot> guard{*this, *s};
+	f(s->value);
+	return true;
+}
+
+template <std::size_t _N, std::size_t _Align>
+typename mpsc_any_queue<_N, _Align>::slot* mpsc_any_queue<_N, _Align>::front()
+{
+	for (;;)
+	{
+		const size_type head = __head.value.load(std::memory_order_relaxed);
+		slot& s = __slots[head & __mask];
+
+		if (s.sequence.load(std::memory_order_acquire) != head + 1)
+			return nullptr;
+
+		if (s.constructed)
+			return &s;
+
+		// a producer failed to construct its value
+		release(s);
+	}
+}
+
+template <std::size_t _N, std::size_t _Align>
+void mpsc_any_queue<_N, _Align>::release(slot& s)
+{
+	const size_type head = __head.value.load(std::memory_order_relaxed);
+
+	s.value.reset();
+	s.constructed = false;
+	s.sequence.store(head + __mask + 1, std::memory_order_release);
+	__head.value.store(head + 1, std::memory_order_relaxed);
+}
@@ -0,0 +1,141 @@
+#pragma once
+
+#include "any_core.hpp"
+
+// Range algorithms on arrays of static_any, to be used by containers: the consecutive elements holding the
+// same type are handled with one call to the vtable, and with a single memcpy for trivial types.
+
+// Destroys the elements of [first, last), their storage is left uninitialized.
+template <std::size_t _S, std::size_t _A>
+inline void destroy_range(static_any<_S, _A>* first, static_any<_S, _A>* last) noexcept
+{
+	while (first != last)
+	{
+		const detail::static_any::vtable* vt = first->__vtable;
+
+		static_any<_S, _A>* end = first + 1;
+		while (end != last && end->__vtable == vt)
+			++end;
+
+		if (vt)
+			detail::static_any::destroy_n(vt, first->__buff.data(), static_cast<std::size_t>(end - first), sizeof(static_any<_S, _A>));
+
+		first = end;
+	}
+}
+
+// Copies the elements of [first, last) to the uninitialized storage starting at d_first, and returns the end
+// of the destination range. If an exception is thrown, the elements already copied are destroyed.
+template <std::size_t _S, std::size_t _A>
+inline static_any<_S, _A>* uninitialized_copy_range(const static_any<_S, _A>* first, const static_any<_S, _A>* last, static_any<_S, _A>* d_first)
+{
+	static_any<_S, _A>* d_run = d_first;
+
+	try
+	{
+		while (first != last)
+		{
+			const detail::static_any::vtable* vt = first->__vtable;
+
+			const static_any<_S, _A>* end = first + 1;
+			while (end != last && end->__vtable == vt)
+				++end;
+
+			const std::size_t count = static_cast<std::size_t>(end - first);
+			if (vt)
+				detail::static_any::copy_n(vt, d_run->__buff.data(), first->__buff.data(), count, sizeof(static_any<_S, _A>));
+
+			for (std::size_t i = 0; i < count; ++i)
+				d_run[i].__vtable = vt;
+
+			d_run += count;
+			first = end;
+		}
+	}
+	catch(...)
+	{
+		destroy_range(d_first, d_run);
+		throw;
+	}
+
+	return d_run;
+}
+
+// Moves the elements of [first, last) to the uninitialized storage starting at d_first, destroys the elements of
+// the source range, and returns the end of the destination range. The types which may throw on move are copied,
+// if one of these copies throws, the source range is left untouched.
+template <std::size_t _S, std::size_t _A>
+inline static_any<_S, _A>* uninitialized_relocate_range(static_any<_S, _A>* first, static_any<_S, _A>* last, static_any<_S, _A>* d_first)
+{
+	using detail::static_any::relocate_by_move;
+	using vtable = detail::static_any::vtable;
+
+	const std::size_t stride = sizeof(static_any<_S, _A>);
+	static_any<_S, _A>* run = first;
+
+	try
+	{
+		while (run != last)
+		{
+			const vtable* vt = run->__vtable;
+
+			static_any<_S, _A>* end = run + 1;
+			while (end != last && end->__vtable == vt)
+				++end;
+
+			if (vt && !relocate_by_move(vt))
+			{
+				static_any<_S, _A>* d_run = d_first + (run - first);
+				detail::static_any::copy_n(vt, d_run->__buff.data(), run->__buff.data(), static_cast<std::size_t>(end - run), stride);
+
+				for (static_any<_S, _A>* d = d_run; d != d_run + (end - run); ++d)
+					d->__vtable = vt;
+			}
+
+			run = end;
+		}
+	}
+	catch(...)
+	{
+		// only the copied values have been constructed in the destination range
+		for (static_any<_S, _A>* s = first; s != run; ++s)
+			if (s->__vtable && !relocate_by_move(s->__vtable))
+				detail::static_any::destroy_n(s->__vtable, d_first[s - first].__buff.data(), 1, stride);
+		throw;
+	}
+
+	// the elements which are trivially movable, whatever their type, are relocated with a single memcpy
+	run = first;
+	while (run != last)
+	{
+		const vtable* vt = run->__vtable;
+		static_any<_S, _A>* d_run = d_first + (run - first);
+		static_any<_S, _A>* end = run + 1;
+
+		if (vt == nullptr || vt->move_n == nullptr)
+		{
+			while (end != last && (end->__vtable == nullptr || end->__vtable->move_n == nullptr))
+				++end;
+
+			std::memcpy(static_cast<void*>(d_run), static_cast<const void*>(run), static_cast<std::size_t>(end - run) * stride);
+		}
+		else
+		{
+			while (end != last && end->__vtable == vt)
+				++end;
+
+			if (relocate_by_move(vt))
+			{
+				detail::static_any::move_n(vt, d_run->__buff.data(), run->__buff.data(), static_cast<std::size_t>(end - run), stride);
+
+				for (static_any<_S, _A>* d = d_run; d != d_run + (end - run); ++d)
+					d->__vtable = vt;
+			}
+		}
+
+		run = end;
+	}
+
+	destroy_range(first, last);
+	return d_first + (last - first);
+}
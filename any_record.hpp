@@ -0,0 +1,237 @@
+#pragma once
+
+#include "any_core.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+namespace detail { namespace static_any {
+
+// smallest unsigned type able to hold the offsets of a buffer of _N bytes
+template <std::size_t _N>
+using record_offset_t = std::conditional_t<_N <= UINT16_MAX, std::uint16_t, std::uint32_t>;
+
+// smallest unsigned type able to index a table of _N type ids
+template <std::size_t _N>
+using record_type_index_t = std::conditional_t<_N <= UINT8_MAX, std::uint8_t, record_offset_t<_N>>;
+
+// default size of the table of types of a record: fields of up to 4 different types
+constexpr std::size_t record_max_types(std::size_t max_fields) { return max_fields < 4 ? max_fields : 4; }
+
+}}
+
+// Sequence of up to _MaxFields trivially copyable fields of up to _MaxTypes different types, packed in a single
+// buffer of _N bytes: each field is aligned after the previous one, and an array of offsets and an array of
+// indices in the table of the types of the record give access to any field in O(1). As static_any_t, it only
+// stores trivially copyable types, and is trivially copyable itself: a record is copied with a single memcpy, and
+// arrays of records can be shipped with any_wire.hpp: all the bytes of a record are zeroed when it is built or
+// cleared, so that none is left uninitialized.
+template <std::size_t _N,
+		  std::size_t _MaxFields = 16,
+		  std::size_t _Align = detail::static_any::default_alignment,
+		  // at most 4 different types by default, whatever _MaxFields: push_back throws std::length_error for a
+		  // fifth one. Up to _MaxFields, for 8 bytes per type.
+		  std::size_t _MaxTypes = detail::static_any::record_max_types(_MaxFields)>
+class static_record
+{
+	static_assert(_Align != 0 && (_Align & (_Align - 1)) == 0, "_Align has to be a power of two");
+	static_assert(_N <= UINT32_MAX, "static_record is too big");
+	static_assert(_MaxFields > 0, "static_record needs at least one field");
+	static_assert(_MaxTypes > 0 && _MaxTypes <= _MaxFields, "static_record needs between one and _MaxFields types");
+
+public:
+	using size_type = std::size_t;
+	using offset_type = detail::static_any::record_offset_t<_N>;
+	using type_index_type = detail::static_any::record_type_index_t<_MaxTypes>;
+
+	static_assert(_MaxFields <= std::numeric_limits<offset_type>::max(), "_MaxFields does not fit in offset_type");
+
+	static constexpr size_type capacity() { return _N; }
+
+	static constexpr size_type max_fields() { return _MaxFields; }
+
+	static constexpr size_type max_types() { return _MaxTypes; }
+
+	static constexpr size_type alignment() { return _Align; }
+
+	// zeroes the whole record, padding included
+	static_record() { std::memset(static_cast<void*>(this), 0, sizeof(*this)); }
+
+	// appends a field, and returns its index. Throws std::length_error if there is no room left for it, or if the
+	// table of types is full.
+	template <class _ValueT>
+	size_type push_back(const _ValueT& value);
+
+	void clear();
+
+	size_type size() const { return __size; }
+
+	bool empty() const { return __size == 0; }
+
+	// bytes used by the fields and their padding
+	size_type bytes() const { return __bytes; }
+
+	template <class _ValueT>
+	bool has(size_type i) const { assert(i < size()); return type_id(i) == id_of<_ValueT>(); }
+
+	// no check, as for static_any_t
+	template <class _ValueT>
+	_ValueT& get(size_type i) { assert(has<_ValueT>(i)); return *reinterpret_cast<_ValueT*>(data(i)); }
+
+	template <class _ValueT>
+	const _ValueT& get(size_type i) const { assert(has<_ValueT>(i)); return *reinterpret_cast<const _ValueT*>(data(i)); }
+
+	template <class _ValueT>
+	_ValueT* try_get(size_type i) { return has<_ValueT>(i) ? reinterpret_cast<_ValueT*>(data(i)) : nullptr; }
+
+	template <class _ValueT>
+	const _ValueT* try_get(size_type i) const { return has<_ValueT>(i) ? reinterpret_cast<const _ValueT*>(data(i)) : nullptr; }
+
+	static_any_type_id_t type_id(size_type i) const { assert(i < size()); return __type_ids[__type_indices[i]]; }
+
+	size_type offset(size_type i) const { assert(i < size()); return __offsets[i]; }
+
+	// calls f on each field holding a _ValueT
+	template <class _ValueT, class _F>
+	void for_each(_F&& f);
+
+	template <class _ValueT, class _F>
+	void for_each(_F&& f) const;
+
+	// same fields with the same bytes
+	bool operator==(const static_record& another) const;
+	bool operator!=(const static_record& another) const { return !(*this == another); }
+
+private:
+	template <class _ValueT>
+	static constexpr static_any_type_id_t id_of() { return detail::static_any::unique_type_id<std::remove_cv_t<_ValueT>>(); }
+
+	// index of the type in the table of types, or the count of types if no field has this type
+	size_type find_type(static_any_type_id_t id) const;
+
+	char* data(size_type i) { return __data.data() + __offsets[i]; }
+	const char* data(size_type i) const { return __data.data() + __offsets[i]; }
+
+	alignas(_Align) std::array<char, _N> __data;
+	std::array<static_any_type_id_t, _MaxTypes> __type_ids;
+	std::array<offset_type, _MaxFields> __offsets;
+	std::array<type_index_type, _MaxFields> __type_indices;
+	offset_type __size;
+	offset_type __bytes;
+	type_index_type __type_count;
+};
+
+template <std::size_t _N, std::size_t _MaxFields, std::size_t _Align, std::size_t _MaxTypes>
+template <class _ValueT>
+typename static_record<_N, _MaxFields, _Align, _MaxTypes>::size_type static_record<_N, _MaxFields, _Align, _MaxTypes>::push_back(const _ValueT& value)
+{
+	static_assert(detail::static_any::is_trivially_copyable<_ValueT>::value, "_ValueT is not trivially copyable");
+	static_assert(capacity() >= sizeof(_ValueT), "_ValueT is too big to be stored in static_record");
+	static_assert(alignment() >= alignof(_ValueT), "_ValueT is over-aligned for static_record");
+
+	const size_type offset = (__bytes + alignof(_ValueT) - 1) / alignof(_ValueT) * alignof(_ValueT);
+
+	const static_any_type_id_t id = id_of<_ValueT>();
+	const size_type type = find_type(id);
+
+	if (__size == max_fields())
+		throw std::length_error("static_record: too many fields");
+	if (offset + sizeof(_ValueT) > capacity())
+		throw std::length_error("static_record: no room left for the field");
+	if (type == max_types())
+		throw std::length_error("static_record: too many types, see _MaxTypes");
+
+	// the padding is zeroed, so that records can be compared byte-wise
+	std::memset(__data.data() + __bytes, 0, offset - __bytes);
+	std::memcpy(__data.data() + offset, &value, sizeof(_ValueT));
+
+	if (type == __type_count)
+		__type_ids[__type_count++] = id;
+
+	__type_indices[__size] = static_cast<type_index_type>(type);
+	__offsets[__size] = static_cast<offset_type>(offset);
+	__bytes = static_cast<offset_type>(offset + sizeof(_ValueT));
+	return __size++;
+}
+
+template <std::size_t _N, std::size_t _MaxFields, std::size_t _Align, std::size_t _MaxTypes>
+void static_record<_N, _MaxFields, _Align, _MaxTypes>::clear()
+{
+	// only the bytes written since the record was zeroed
+	std::memset(__data.data(), 0, __bytes);
+	std::memset(__type_ids.data(), 0, __type_count * sizeof(static_any_type_id_t));
+	std::memset(__offsets.data(), 0, __size * sizeof(offset_type));
+	std::memset(__type_indices.data(), 0, __size * sizeof(type_index_type));
+
+	__size = 0;
+	__bytes = 0;
+	__type_count = 0;
+}
+
+template <std::size_t _N, std::size_t _MaxFields, std::size_t _Align, std::size_t _MaxTypes>
+template <class _ValueT, class _F>
+void static_record<_N, _MaxFields, _Align, _MaxTypes>::for_each(_F&& f)
+{
+	const size_type type = find_type(id_of<_ValueT>());
+
+	for (size_type i = 0; i < size(); ++i)
+		if (__type_indices[i] == type)
+			f(*reinterpret_cast<_ValueT*>(data(i)));
+}
+
+template <std::size_t _N, std::size_t _MaxFields, std::size_t _Align, std::size_t _MaxTypes>
+template <class _ValueT, class _F>
+void static_record<_N, _MaxFields, _Align, _MaxTypes>::for_each(_F&& f) const
+{
+	const size_type type = find_type(id_of<_ValueT>());
+
+	for (size_type i = 0; i < size(); ++i)
+		if (__type_indices[i] == type)
+			f(*reinterpret_cast<const _ValueT*>(data(i)));
+}
+
+template <std::size_t _N, std::size_t _MaxFields, std::size_t _Align, std::size_t _MaxTypes>
+bool static_record<_N, _MaxFields, _Align, _MaxTypes>::operator==(const static_record& another) const
+{
+	// the offsets follow from the types, and the table of types from the order of the fields
+	return __size == another.__size &&
+		__bytes == another.__bytes &&
+		__type_count == another.__type_count &&
+		std::memcmp(__type_ids.data(), another.__type_ids.data(), __type_count * sizeof(static_any_type_id_t)) == 0 &&
+		std::memcmp(__type_indices.data(), another.__type_indices.data(), __size * sizeof(type_index_type)) == 0 &&
+		std::memcmp(__data.data(), another.__data.data(), __bytes) == 0;
+}
+
+template <std::size_t _N, std::size_t _MaxFields, std::size_t _Align, std::size_t _MaxTypes>
+typename static_record<_N, _MaxFields, _Align, _MaxTypes>::size_type static_record<_N, _MaxFields, _Align, _MaxTypes>::find_type(static_any_type_id_t id) const
+{
+	size_type type = 0;
+	while (type != __type_count && __type_ids[type] != id)
+		++type;
+	return type;
+}
+
+// Calls f on the field i of each record of [first, last) holding a _ValueT: a column of records sharing a
+// schema. Returns the number of fields visited.
+template <class _ValueT, std::size_t _N, std::size_t _MaxFields, std::size_t _Align, std::size_t _MaxTypes, class _F>
+inline std::size_t for_each_in_column(const static_record<_N, _MaxFields, _Align, _MaxTypes>* first,
+									  const static_record<_N, _MaxFields, _Align, _MaxTypes>* last,
+									  std::size_t i,
+									  _F&& f)
+{
+	std::size_t count = 0;
+	for (; first != last; ++first)
+	{
+		if (i < first->size())
+		{
+			if (const _ValueT* value = first->template try_get<_ValueT>(i))
+			{
+				f(*value);
+				++count;
+			}
+		}
+	}
+	return count;
+}
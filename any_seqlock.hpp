@@ -0,0 +1,155 @@
+#pragma once
+
+#include "any_core.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+
+namespace detail { namespace static_any {
+
+template <std::size_t _Size>
+struct unsigned_word;
+
+template <> struct unsigned_word<1> { using type = std::uint8_t; };
+template <> struct unsigned_word<2> { using type = std::uint16_t; };
+template <> struct unsigned_word<4> { using type = std::uint32_t; };
+template <> struct unsigned_word<8> { using type = std::uint64_t; };
+
+// the widest word dividing the buffer for which atomics are lock-free
+constexpr std::size_t seqlock_word_size(std::size_t align)
+{
+	return align < sizeof(void*) ? align : sizeof(void*);
+}
+
+}}
+
+// Cell holding a static_any_t<_N, _Align>, written by a single thread and read by any number of threads
+// without locks. The writer bumps a sequence number to an odd value, copies the value and bumps it again; a
+// reader copies the value and retries if the sequence number was odd or has changed meanwhile. Readers only read
+// the cell, so its cache line stays shared between their cores as long as it is not written -- keep it apart
+// from data written often.
+//
+// The value is copied as relaxed atomic words rather than with a memcpy, which would race with the writer: on
+// the usual platforms, these are plain loads and stores.
+template <std::size_t _N, std::size_t _Align = detail::static_any::natural_alignment(_N)>
+class seqlock_any_t
+{
+public:
+	using value_type = static_any_t<_N, _Align>;
+	using size_type = std::size_t;
+
+	static constexpr size_type capacity() { return _N; }
+
+	static constexpr size_type alignment() { return _Align; }
+
+	// the cell is zero-filled
+	seqlock_any_t();
+
+	explicit seqlock_any_t(const value_type& value);
+
+	seqlock_any_t(const seqlock_any_t&) = delete;
+	seqlock_any_t& operator=(const seqlock_any_t&) = delete;
+
+	// writer side, from a single thread at a time
+	void store(const value_type& value);
+
+	// the bytes after the value are zero-filled
+	template <class _ValueT,
+			  class = std::enable_if_t<!std::is_same<std::decay_t<_ValueT>, value_type>::value>>
+	void store(_ValueT&& t);
+
+	// reader side, from any thread: retries until the copy is not torn
+	value_type load() const;
+
+	template <class _ValueT>
+	_ValueT load() const { return load().template get<_ValueT>(); }
+
+	// single attempt: returns false if the writer was running, value is then unspecified
+	bool try_load(value_type& value) const;
+
+	// even, incremented by 2 on each store
+	std::uint64_t version() const { return __sequence.load(std::memory_order_acquire); }
+
+private:
+	using word_t = typename detail::static_any::unsigned_word<detail::static_any::seqlock_word_size(_Align)>::type;
+
+	static constexpr size_type word_count = sizeof(value_type) / sizeof(word_t);
+
+	static_assert(sizeof(value_type) % sizeof(word_t) == 0, "static_any_t is not made of whole words");
+
+	std::atomic<std::uint64_t> __sequence{0};
+	std::atomic<word_t> __words[word_count];
+};
+
+template <std::size_t _N, std::size_t _Align>
+seqlock_any_t<_N, _Align>::seqlock_any_t()
+{
+	for (std::atomic<word_t>& word : __words)
+		word.store(0, std::memory_order_relaxed);
+}
+
+template <std::size_t _N, std::size_t _Align>
+seqlock_any_t<_N, _Align>::seqlock_any_t(const value_type& value)
+{
+	word_t words[word_count];
+	std::memcpy(words, &value, sizeof(value_type));
+
+	for (size_type i = 0; i < word_count; ++i)
+		__words[i].store(words[i], std::memory_order_relaxed);
+}
+
+template <std::size_t _N, std::size_t _Align>
+void seqlock_any_t<_N, _Align>::store(const value_type& value)
+{
+	word_t words[word_count];
+	std::memcpy(words, &value, sizeof(value_type));
+
+	const std::uint64_t sequence = __sequence.load(std::memory_order_relaxed);
+	__sequence.store(sequence + 1, std::memory_order_relaxed);
+	// the words cannot be written before the sequence number is odd
+	std::atomic_thread_fence(std::memory_order_release);
+
+	for (size_type i = 0; i < word_count; ++i)
+		__words[i].store(words[i], std::memory_order_relaxed);
+
+	__sequence.store(sequence + 2, std::memory_order_release);
+}
+
+template <std::size_t _N, std::size_t _Align>
+template <class _ValueT, class>
+void seqlock_any_t<_N, _Align>::store(_ValueT&& t)
+{
+	value_type value{};
+	value = std::forward<_ValueT>(t);
+	store(value);
+}
+
+template <std::size_t _N, std::size_t _Align>
+typename seqlock_any_t<_N, _Align>::value_type seqlock_any_t<_N, _Align>::load() const
+{
+	value_type value;
+	while (!try_load(value))
+		;
+	return value;
+}
+
+template <std::size_t _N, std::size_t _Align>
+bool seqlock_any_t<_N, _Align>::try_load(value_type& value) const
+{
+	const std::uint64_t before = __sequence.load(std::memory_order_acquire);
+	if (before % 2 != 0)
+		return false;
+
+	word_t words[word_count];
+	for (size_type i = 0; i < word_count; ++i)
+		words[i] = __words[i].load(std::memory_order_relaxed);
+
+	// the words cannot be read after the sequence number
+	std::atomic_thread_fence(std::memory_order_acquire);
+	if (__sequence.load(std::memory_order_relaxed) != before)
+		return false;
+
+	std::memcpy(static_cast<void*>(&value), words, sizeof(value_type));
+	return true;
+}
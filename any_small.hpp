@@ -0,0 +1,437 @@
+#pragma once
+
+#include "any_core.hpp"
+
+#include <memory>
+
+template <std::size_t _N, class _Alloc = std::allocator<char>>
+class small_any;
+
+template <std::size_t _N, class _Alloc>
+class small_any :
+	private std::allocator_traits<_Alloc>::template rebind_alloc<std::max_align_t>
+{
+	static_assert(_N >= sizeof(void*), "small_any needs to be able to store a pointer");
+
+	template <typename _T>
+	struct is_small_any : public std::false_type {};
+
+	template <std::size_t _M, class _AllocM>
+	struct is_small_any<small_any<_M, _AllocM>> : public std::true_type {};
+
+	// an allocator_type is taken by the allocator constructor, even a non-const lvalue
+	template <typename _T>
+	using is_allocator = std::is_same<std::decay_t<_T>, _Alloc>;
+
+public:
+	using size_type = std::size_t;
+	using allocator_type = _Alloc;
+
+	small_any() = default;
+
+	explicit small_any(const allocator_type& alloc) :
+		storage_allocator(alloc)
+	{}
+
+	template <class _T,
+			  class = std::enable_if_t<!is_small_any<std::decay_t<_T>>::value && !is_allocator<_T>::value>>
+	small_any(_T&& t, const allocator_type& alloc = allocator_type()) :
+		storage_allocator(alloc)
+	{
+		construct<std::decay_t<_T>>(std::forward<_T>(t));
+	}
+
+	small_any(const small_any& another) :
+		storage_allocator(std::allocator_traits<storage_allocator>::select_on_container_copy_construction(another.get_storage_allocator()))
+	{
+		copy_from(another);
+	}
+
+	small_any(small_any&& another) noexcept :
+		storage_allocator(std::move(another.get_storage_allocator()))
+	{
+		move_from(std::move(another));
+	}
+
+	~small_any() { destroy(); }
+
+	template <class _T,
+			  class = std::enable_if_t<!is_small_any<std::decay_t<_T>>::value && !is_allocator<_T>::value>>
+	small_any& operator=(_T&& t)
+	{
+		*this = small_any(std::forward<_T>(t), get_allocator());
+		return *this;
+	}
+
+	// the allocator is propagated as for a container
+	small_any& operator=(const small_any& another)
+	{
+		if (this != &another)
+			copy_assign(another, typename storage_traits::propagate_on_container_copy_assignment{});
+		return *this;
+	}
+
+	// the allocation is stolen if the allocator is propagated or equal, otherwise the value is moved to an
+	// allocation of this small_any, which may throw
+	small_any& operator=(small_any&& another) noexcept(storage_traits::propagate_on_container_move_assignment::value || storage_traits::is_always_equal::value)
+	{
+		if (this != &another)
+			move_assign(std::move(another), typename storage_traits::propagate_on_container_move_assignment{});
+		return *this;
+	}
+
+	void reset() { destroy(); }
+
+	template <class _T>
+	const _T& get() const;
+
+	template <class _T>
+	_T& get();
+
+	template <class _T>
+	const _T* try_get() const;
+
+	template <class _T>
+	_T* try_get();
+
+	template <class _T>
+	bool has() const { return detail::static_any::has_type<_T>(__vtable); }
+
+	const static_any_type_info& type() const { return empty() ? static_any_typeid<void>() : *__vtable->type_info; }
+
+	static_any_type_id_t type_id() const { return detail::static_any::type_id(__vtable); }
+
+	bool empty() const { return __vtable == nullptr; }
+
+	size_type size() const { return empty() ? 0 : __vtable->size; }
+
+	static constexpr size_type capacity() { return _N; }
+
+	// true if the stored value lies in the inline buffer, false if it has been allocated
+	bool is_inline() const { return !empty() && is_inline(__vtable); }
+
+	template <class _T, class... Args>
+	void emplace(Args&&... args)
+	{
+		destroy();
+		construct<_T>(std::forward<Args>(args)...);
+	}
+
+	allocator_type get_allocator() const { return allocator_type(get_storage_allocator()); }
+
+private:
+	using vtable = detail::static_any::vtable;
+	using storage_allocator = typename std::allocator_traits<_Alloc>::template rebind_alloc<std::max_align_t>;
+	using storage_traits = std::allocator_traits<storage_allocator>;
+
+	static constexpr std::size_t inline_alignment = detail::static_any::default_alignment;
+
+	// only types which can be moved without throwing are stored inline, so that moving a small_any never throws
+	static constexpr bool is_inline(std::size_t size, std::size_t align, bool nothrow_move)
+	{
+		return size <= _N && align <= inline_alignment && nothrow_move;
+	}
+
+	static bool is_inline(const vtable* vt) { return is_inline(vt->size, vt->align, vt->nothrow_move); }
+
+	storage_allocator& get_storage_allocator() { return *this; }
+	const storage_allocator& get_storage_allocator() const { return *this; }
+
+	template <class _T, class... Args>
+	void construct(Args&&... args);
+
+	void copy_from(const small_any& another);
+
+	void move_from(small_any&& another) noexcept;
+
+	// move_from() with an allocator which may differ: the value is moved to an allocation of this small_any
+	void move_from_unequal(small_any&& another);
+
+	void copy_assign(const small_any& another, std::true_type);
+	void copy_assign(const small_any& another, std::false_type);
+
+	void move_assign(small_any&& another, std::true_type) noexcept;
+	void move_assign(small_any&& another, std::false_type);
+
+	void destroy();
+
+	void* allocate(std::size_t size);
+
+	void deallocate(void* ptr, std::size_t size);
+
+	static std::size_t blocks(std::size_t size) { return (size + sizeof(std::max_align_t) - 1) / sizeof(std::max_align_t); }
+
+	void*& heap_ptr() { return *reinterpret_cast<void**>(__buff.data()); }
+	void* const& heap_ptr() const { return *reinterpret_cast<void* const*>(__buff.data()); }
+
+	void* object() { return is_inline(__vtable) ? __buff.data() : heap_ptr(); }
+	const void* object() const { return is_inline(__vtable) ? __buff.data() : heap_ptr(); }
+
+	alignas(inline_alignment) std::array<char, _N> __buff;
+	const vtable* __vtable{};
+
+	template <class _ValueT, std::size_t _S, class _A>
+	friend _ValueT* any_cast(small_any<_S, _A>*);
+};
+
+template <std::size_t _N, class _Alloc>
+template <class _T, class... Args>
+void small_any<_N, _Alloc>::construct(Args&&... args)
+{
+	assert(__vtable == nullptr);
+
+	if (is_inline(sizeof(_T), alignof(_T), std::is_nothrow_move_constructible<_T>::value))
+	{
+		new(__buff.data()) _T(std::forward<Args>(args)...);
+	}
+	else
+	{
+		static_assert(alignof(_T) <= alignof(std::max_align_t), "_T is over-aligned for small_any");
+
+		void* ptr = allocate(sizeof(_T));
+
+		try {
+			new(ptr) _T(std::forward<Args>(args)...);
+		}
+		catch(...) {
+			deallocate(ptr, sizeof(_T));
+			throw;
+		}
+
+		heap_ptr() = ptr;
+	}
+
+	__vtable = detail::static_any::get_vtable_for_type<_T>();
+}
+
+template <std::size_t _N, class _Alloc>
+void small_any<_N, _Alloc>::copy_from(const small_any& another)
+{
+	assert(__vtable == nullptr);
+
+	const vtable* vt = another.__vtable;
+	if (vt == nullptr)
+		return;
+
+	if (is_inline(vt))
+	{
+		if (vt->copy)
+			vt->copy(__buff.data(), another.__buff.data());
+		else
+			std::memcpy(__buff.data(), another.__buff.data(), _N);
+	}
+	else
+	{
+		void* ptr = allocate(vt->size);
+
+		try {
+			if (vt->copy)
+				vt->copy(ptr, another.heap_ptr());
+			else
+				std::memcpy(ptr, another.heap_ptr(), vt->size);
+		}
+		catch(...) {
+			deallocate(ptr, vt->size);
+			throw;
+		}
+
+		heap_ptr() = ptr;
+	}
+
+	__vtable = vt;
+}
+
+template <std::size_t _N, class _Alloc>
+void small_any<_N, _Alloc>::move_from(small_any&& another) noexcept
+{
+	assert(__vtable == nullptr);
+
+	const vtable* vt = another.__vtable;
+	if (vt == nullptr)
+		return;
+
+	if (is_inline(vt))
+	{
+		if (vt->move)
+			vt->move(__buff.data(), another.__buff.data());
+		else
+			std::memcpy(__buff.data(), another.__buff.data(), _N);
+
+		__vtable = vt;
+	}
+	else
+	{
+		// the allocation is stolen: another is left empty
+		heap_ptr() = another.heap_ptr();
+		__vtable = vt;
+		another.__vtable = nullptr;
+	}
+}
+
+template <std::size_t _N, class _Alloc>
+void small_any<_N, _Alloc>::move_from_unequal(small_any&& another)
+{
+	assert(__vtable == nullptr);
+
+	const vtable* vt = another.__vtable;
+	if (vt == nullptr || is_inline(vt) || get_storage_allocator() == another.get_storage_allocator())
+	{
+		move_from(std::move(another));
+		return;
+	}
+
+	void* ptr = allocate(vt->size);
+
+	try {
+		if (vt->move)
+			vt->move(ptr, another.heap_ptr());
+		else
+			std::memcpy(ptr, another.heap_ptr(), vt->size);
+	}
+	catch(...) {
+		deallocate(ptr, vt->size);
+		throw;
+	}
+
+	heap_ptr() = ptr;
+	__vtable = vt;
+	// another is left empty, as when its allocation is stolen
+	another.destroy();
+}
+
+template <std::size_t _N, class _Alloc>
+void small_any<_N, _Alloc>::copy_assign(const small_any& another, std::true_type)
+{
+	// copied with the allocator of another first, for the strong guarantee
+	small_any copy(allocator_type(another.get_storage_allocator()));
+	copy.copy_from(another);
+
+	destroy();
+	get_storage_allocator() = another.get_storage_allocator();
+	move_from(std::move(copy));
+}
+
+template <std::size_t _N, class _Alloc>
+void small_any<_N, _Alloc>::copy_assign(const small_any& another, std::false_type)
+{
+	small_any copy(get_allocator());
+	copy.copy_from(another);
+
+	destroy();
+	move_from(std::move(copy));
+}
+
+template <std::size_t _N, class _Alloc>
+void small_any<_N, _Alloc>::move_assign(small_any&& another, std::true_type) noexcept
+{
+	destroy();
+	get_storage_allocator() = std::move(another.get_storage_allocator());
+	move_from(std::move(another));
+}
+
+template <std::size_t _N, class _Alloc>
+void small_any<_N, _Alloc>::move_assign(small_any&& another, std::false_type)
+{
+	destroy();
+	move_from_unequal(std::move(another));
+}
+
+template <std::size_t _N, class _Alloc>
+void small_any<_N, _Alloc>::destroy()
+{
+	if (__vtable)
+	{
+		void* ptr = object();
+
+		if (__vtable->destroy)
+			__vtable->destroy(ptr);
+
+		if (!is_inline(__vtable))
+			deallocate(ptr, __vtable->size);
+
+		__vtable = nullptr;
+	}
+}
+
+template <std::size_t _N, class _Alloc>
+void* small_any<_N, _Alloc>::allocate(std::size_t size)
+{
+	auto ptr = storage_traits::allocate(get_storage_allocator(), blocks(size));
+	return static_cast<void*>(std::addressof(*ptr));
+}
+
+template <std::size_t _N, class _Alloc>
+void small_any<_N, _Alloc>::deallocate(void* ptr, std::size_t size)
+{
+	using storage_pointer = typename storage_traits::pointer;
+	storage_traits::deallocate(get_storage_allocator(),
+							   std::pointer_traits<storage_pointer>::pointer_to(*static_cast<std::max_align_t*>(ptr)),
+							   blocks(size));
+}
+
+template <class _ValueT,
+		  std::size_t _S,
+		  class _A>
+inline _ValueT* any_cast(small_any<_S, _A>* a)
+{
+	if (!a->template has<_ValueT>())
+		return nullptr;
+
+	return static_cast<_ValueT*>(a->object());
+}
+
+template <class _ValueT,
+		  std::size_t _S,
+		  class _A>
+inline const _ValueT* any_cast(const small_any<_S, _A>* a)
+{
+	return any_cast<const _ValueT>(const_cast<small_any<_S, _A>*>(a));
+}
+
+template <class _ValueT,
+		  std::size_t _S,
+		  class _A>
+inline _ValueT& any_cast(small_any<_S, _A>& a)
+{
+	_ValueT* ptr = any_cast<_ValueT>(&a);
+	if (ptr == nullptr)
+		throw bad_any_cast(a.type(), static_any_typeid<_ValueT>());
+
+	return *ptr;
+}
+
+template <class _ValueT,
+		  std::size_t _S,
+		  class _A>
+inline const _ValueT& any_cast(const small_any<_S, _A>& a)
+{
+	return any_cast<const _ValueT>(const_cast<small_any<_S, _A>&>(a));
+}
+
+template <std::size_t _N, class _Alloc>
+template <class _T>
+const _T& small_any<_N, _Alloc>::get() const
+{
+	return any_cast<_T>(*this);
+}
+
+template <std::size_t _N, class _Alloc>
+template <class _T>
+_T& small_any<_N, _Alloc>::get()
+{
+	return any_cast<_T>(*this);
+}
+
+template <std::size_t _N, class _Alloc>
+template <class _T>
+const _T* small_any<_N, _Alloc>::try_get() const
+{
+	return any_cast<_T>(this);
+}
+
+template <std::size_t _N, class _Alloc>
+template <class _T>
+_T* small_any<_N, _Alloc>::try_get()
+{
+	return any_cast<_T>(this);
+}
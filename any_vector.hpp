@@ -0,0 +1,1103 @@
+#pragma once
+
+#include "any_core.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <vector>
+
+#if !defined(STATIC_ANY_NO_SIMD)
+# if defined(__AVX2__)
+#  include <immintrin.h>
+# elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  include <emmintrin.h>
+#  define STATIC_ANY_SSE2
+# elif defined(__ARM_NEON)
+#  include <arm_neon.h>
+# endif
+#endif
+
+namespace detail { namespace static_any {
+
+template <std::size_t _N, std::size_t _Align>
+struct alignas(_Align) slot
+{
+	char data[_N];
+};
+
+// Scans of the tags of static_any_vector, tag_lanes tags at a time: 16 with AVX2, 8 with SSE2 or NEON, one by
+// one on other targets or with STATIC_ANY_NO_SIMD defined. match_tags returns a mask of tag_mask_bits bits per
+// tag equal to the one searched, the lowest bits for the first tag.
+#if !defined(STATIC_ANY_NO_SIMD) && defined(__AVX2__)
+
+constexpr std::size_t tag_lanes = 16;
+constexpr unsigned tag_mask_bits = 2;
+
+inline std::uint64_t match_tags(const std::uint16_t* tags, std::uint16_t tag)
+{
+	const __m256i values = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(tags));
+	const __m256i equal = _mm256_cmpeq_epi16(values, _mm256_set1_epi16(static_cast<short>(tag)));
+	return static_cast<std::uint32_t>(_mm256_movemask_epi8(equal));
+}
+
+#elif !defined(STATIC_ANY_NO_SIMD) && defined(STATIC_ANY_SSE2)
+
+constexpr std::size_t tag_lanes = 8;
+constexpr unsigned tag_mask_bits = 2;
+
+inline std::uint64_t match_tags(const std::uint16_t* tags, std::uint16_t tag)
+{
+	const __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(tags));
+	const __m128i equal = _mm_cmpeq_epi16(values, _mm_set1_epi16(static_cast<short>(tag)));
+	return static_cast<std::uint32_t>(_mm_movemask_epi8(equal));
+}
+
+#elif !defined(STATIC_ANY_NO_SIMD) && defined(__ARM_NEON)
+
+constexpr std::size_t tag_lanes = 8;
+constexpr unsigned tag_mask_bits = 8;
+
+inline std::uint64_t match_tags(const std::uint16_t* tags, std::uint16_t tag)
+{
+	const uint16x8_t equal = vceqq_u16(vld1q_u16(tags), vdupq_n_u16(tag));
+	return vget_lane_u64(vreinterpret_u64_u8(vmovn_u16(equal)), 0);
+}
+
+#else
+
+constexpr std::size_t tag_lanes = 1;
+constexpr unsigned tag_mask_bits = 1;
+
+inline std::uint64_t match_tags(const std::uint16_t* tags, std::uint16_t tag)
+{
+	return *tags == tag ? 1 : 0;
+}
+
+#endif
+
+inline unsigned popcount(std::uint64_t mask)
+{
+#if defined(__GNUC__)
+	return static_cast<unsigned>(__builtin_popcountll(mask));
+#else
+	unsigned count = 0;
+	for (; mask != 0; mask &= mask - 1)
+		++count;
+	return count;
+#endif
+}
+
+// index of the lowest bit set, mask being non zero
+inline unsigned lowest_bit(std::uint64_t mask)
+{
+#if defined(__GNUC__)
+	return static_cast<unsigned>(__builtin_ctzll(mask));
+#else
+	unsigned bit = 0;
+	for (; (mask & 1) == 0; mask >>= 1)
+		++bit;
+	return bit;
+#endif
+}
+
+inline std::size_t count_tags(const std::uint16_t* tags, std::size_t size, std::uint16_t tag)
+{
+	std::size_t bits = 0;
+	std::size_t i = 0;
+
+	for (; i + tag_lanes <= size; i += tag_lanes)
+		bits += popcount(match_tags(tags + i, tag));
+
+	std::size_t count = bits / tag_mask_bits;
+	for (; i < size; ++i)
+		count += tags[i] == tag ? 1 : 0;
+
+	return count;
+}
+
+// calls f(i) for the index of each tag equal to the one searched, in order
+template <class _F>
+inline void for_each_tag(const std::uint16_t* tags, std::size_t size, std::uint16_t tag, _F&& f)
+{
+	constexpr std::uint64_t lane_mask = (std::uint64_t(1) << tag_mask_bits) - 1;
+
+	std::size_t i = 0;
+	for (; i + tag_lanes <= size; i += tag_lanes)
+	{
+		for (std::uint64_t mask = match_tags(tags + i, tag); mask != 0; )
+		{
+			const unsigned lane = lowest_bit(mask) / tag_mask_bits;
+			f(i + lane);
+			mask &= ~(lane_mask << (lane * tag_mask_bits));
+		}
+	}
+
+	for (; i < size; ++i)
+		if (tags[i] == tag)
+			f(i);
+}
+
+// std::allocator_traits propagation: the allocator is only assigned or swapped if the trait is true, so that
+// allocators which can not be assigned, as std::pmr::polymorphic_allocator, are never
+template <class _Alloc, class _Other>
+inline void assign_allocator(_Alloc& alloc, _Other&& other, std::true_type) { alloc = std::forward<_Other>(other); }
+
+template <class _Alloc, class _Other>
+inline void assign_allocator(_Alloc&, _Other&&, std::false_type) {}
+
+template <class _Alloc>
+inline void swap_allocators(_Alloc& a, _Alloc& b, std::true_type)
+{
+	using std::swap;
+	swap(a, b);
+}
+
+template <class _Alloc>
+inline void swap_allocators(_Alloc&, _Alloc&, std::false_type) {}
+
+}}
+
+// Sequence of static_any<_N, _Align> stored as a structure of arrays: a dense array of 16-bit tags, indexing
+// a per-container table of types, and an array of payloads. Looking for the elements of a given type only
+// reads the tags, and the elements are copied, moved and destroyed with one call per run of consecutive
+// elements of the same type. The payloads, tags and types are allocated through _Alloc, which is propagated as for
+// the standard containers: if it is not, and the allocators are not equal, the elements are copied or moved to
+// the storage of the vector instead of being stolen.
+template <std::size_t _N, std::size_t _Align = detail::static_any::default_alignment, class _Alloc = std::allocator<char>>
+class static_any_vector :
+	private std::allocator_traits<_Alloc>::template rebind_alloc<detail::static_any::slot<_N, _Align>>
+{
+	static_assert(_Align != 0 && (_Align & (_Align - 1)) == 0, "_Align has to be a power of two");
+	static_assert(_Align <= alignof(std::max_align_t), "_Align is over-aligned for static_any_vector");
+
+	template <class _T>
+	using is_static_any = typename static_any<_N, _Align>::template is_static_any<std::decay_t<_T>>;
+
+public:
+	using size_type = std::size_t;
+	using tag_type = std::uint16_t;
+	using allocator_type = _Alloc;
+
+private:
+	using slot = detail::static_any::slot<_N, _Align>;
+	using slot_allocator = typename std::allocator_traits<_Alloc>::template rebind_alloc<slot>;
+	using slot_traits = std::allocator_traits<slot_allocator>;
+
+	static constexpr bool is_move_assignment_noexcept()
+	{
+		return slot_traits::propagate_on_container_move_assignment::value || slot_traits::is_always_equal::value;
+	}
+
+	static constexpr bool is_swap_noexcept()
+	{
+		return slot_traits::propagate_on_container_swap::value || slot_traits::is_always_equal::value;
+	}
+
+public:
+
+	// tag of the empty elements
+	static constexpr tag_type empty_tag = 0;
+
+	static_any_vector() = default;
+
+	explicit static_any_vector(const allocator_type& alloc);
+
+	~static_any_vector();
+
+	static_any_vector(const static_any_vector&);
+	static_any_vector(static_any_vector&&) noexcept;
+
+	static_any_vector(const static_any_vector&, const allocator_type& alloc);
+	static_any_vector(static_any_vector&&, const allocator_type& alloc);
+
+	static_any_vector& operator=(const static_any_vector&);
+	static_any_vector& operator=(static_any_vector&&) noexcept(is_move_assignment_noexcept());
+
+	void swap(static_any_vector&) noexcept(is_swap_noexcept());
+
+	template <class _T,
+			  class = std::enable_if_t<!is_static_any<_T>::value>>
+	void push_back(_T&& t);
+
+	template <std::size_t _M, std::size_t _AlignM, class = std::enable_if_t<_M <= _N && _AlignM <= _Align>>
+	void push_back(const static_any<_M, _AlignM>& any);
+
+	template <class _T, class... Args>
+	void emplace_back(Args&&... args);
+
+	// appends count copies of value, with a single growth
+	template <class _T>
+	void append(size_type count, const _T& value);
+
+	// appends the values or static_any of the range. If an exception is thrown, the vector is left unchanged
+	template <class _InputIt,
+			  class = std::enable_if_t<!std::is_integral<_InputIt>::value>>
+	void append(_InputIt first, _InputIt last);
+
+	void pop_back();
+
+	void clear();
+
+	void reserve(size_type capacity);
+
+	size_type size() const { return __tags.size(); }
+
+	bool empty() const { return __tags.empty(); }
+
+	size_type capacity() const { return __capacity; }
+
+	allocator_type get_allocator() const { return allocator_type(get_slot_allocator()); }
+
+	template <class _T>
+	bool has(size_type i) const;
+
+	template <class _T>
+	const _T& get(size_type i) const;
+
+	template <class _T>
+	_T& get(size_type i);
+
+	template <class _T>
+	const _T* try_get(size_type i) const;
+
+	template <class _T>
+	_T* try_get(size_type i);
+
+	const static_any_type_info& type(size_type i) const;
+
+	static_any_type_id_t type_id(size_type i) const;
+
+	// elements with the same tag hold the same type
+	tag_type tag(size_type i) const { return __tags[i]; }
+
+	// calls f on each element holding a _T, in order
+	template <class _T, class _F>
+	void for_each(_F&& f);
+
+	template <class _T, class _F>
+	void for_each(_F&& f) const;
+
+	template <class _T>
+	size_type count() const;
+
+	// writes the index of each element holding a _T to out, in order
+	template <class _T, class _OutputIt>
+	_OutputIt find_all(_OutputIt out) const;
+
+	// stable partition: moves the elements holding a _T before the others, keeping the order within both
+	// groups, and returns their count. The elements are relocated to a new storage, with the strong guarantee.
+	template <class _T>
+	size_type partition();
+
+private:
+	using vtable = detail::static_any::vtable;
+
+	template <class _T>
+	using vector = std::vector<_T, typename std::allocator_traits<_Alloc>::template rebind_alloc<_T>>;
+
+	static constexpr size_type stride = sizeof(slot);
+
+	void* data(size_type i) { return __data[i].data; }
+
+	const void* data(size_type i) const { return __data[i].data; }
+
+	const vtable* vtable_of(size_type i) const;
+
+	// returns the tag of the vtable, adding it to the table of types if needed
+	tag_type tag_for(const vtable* vt);
+
+	// returns empty_tag if no element of type _T has ever been stored
+	template <class _T>
+	tag_type find_tag() const;
+
+	// calls f(vtable, first, count) for each run of non-empty elements with the same tag in [first, last)
+	template <class _F>
+	void for_each_run(size_type first, size_type last, _F&& f) const;
+
+	// elements [first, first + count) relocated to the position dst of the new storage
+	struct segment
+	{
+		size_type first;
+		size_type count;
+		size_type dst;
+	};
+
+	// true if the vtable entry is null, i.e. the operation is trivial, for all the types stored
+	template <class _Entry>
+	bool all_trivial(_Entry vtable::*entry) const;
+
+	void grow(size_type count);
+
+	// constructs count elements of the vtable at the end with construct(first slot), which leaves nothing
+	// constructed if it throws. If the capacity is exceeded, they are constructed in the new storage before the
+	// old elements are relocated, so that the arguments may be elements of the vector itself.
+	template <class _Construct>
+	void construct_back(const vtable* vt, size_type count, _Construct&& construct);
+
+	void copy_to(slot* dst) const;
+	void relocate_to(slot* dst);
+	void relocate_to(slot* dst, const segment* segments, size_type count);
+	void destroy_runs(slot* first, size_type begin, size_type end) const;
+
+	// swaps the elements, the tags and the types, but not the allocators: they have to be equal, or swapped
+	void swap_storage(static_any_vector& other) noexcept;
+
+	// destroys the elements and deallocates the storage
+	void release() noexcept;
+
+	// takes the storage of other, whose allocator is equal, and leaves other empty
+	void take_storage(static_any_vector& other);
+
+	// takes the elements of other, relocated to a new storage allocated by this vector, and leaves other empty
+	void relocate_from(static_any_vector& other);
+
+	slot_allocator& get_slot_allocator() { return *this; }
+	const slot_allocator& get_slot_allocator() const { return *this; }
+
+	slot* allocate(size_type capacity);
+	void deallocate(slot* p, size_type capacity);
+
+	vector<tag_type> __tags;
+	vector<const vtable*> __types;
+	slot* __data{};
+	size_type __capacity{};
+};
+
+template <std::size_t _N, std::size_t _Align, class _Alloc>
+constexpr typename static_any_vector<_N, _Align, _Alloc>::tag_type static_any_vector<_N, _Align, _Alloc>::empty_tag;
+
+template <std::size_t _N, std::size_t _Align, class _Alloc>
+constexpr typename static_any_vector<_N, _Align, _Alloc>::size_type static_any_vector<_N, _Align, _Alloc>::stride;
+
+template <std::size_t _N, std::size_t _Align, class _Alloc>
+static_any_vector<_N, _Align, _Alloc>::~static_any_vector()
+{
+	clear();
+	deallocate(__data, __capacity);
+}
+
+template <std::size_t _N, std::size_t _Align, class _Alloc>
+static_any_vector<_N, _Align, _Alloc>::static_any_vector(const allocator_type& alloc) :
+	slot_allocator(alloc),
+	__tags(alloc),
+	__types(alloc)
+{}
+
+template <std::size_t _N, std::size_t _Align, class _Alloc>
+static_any_vector<_N, _Align, _Alloc>::static_any_vector(const static_any_vector& other) :
+	static_any_vector(other, allocator_type(slot_traits::select_on_container_copy_construction(other.get_slot_allocator())))
+{}
+
+template <std::size_t _N, std::size_t _Align, class _Alloc>
+static_any_vector<_N, _Align, _Alloc>::static_any_vector(const static_any_vector& other, const allocator_type& alloc) :
+	slot_allocator(alloc),
+	__tags(other.__tags, alloc),
+	__types(other.__types, alloc)
+{
+	if (other.empty())
+		return;
+
+	slot* new_data = allocate(other.size());
+	try
+	{
+		other.copy_to(new_data);
+	}
+	catch(...)
+	{
+		deallocate(new_data, other.size());
+		throw;
+	}
+
+	__data = new_data;
+	__capacity = other.size();
+}
+
+template <std::size_t _N, std::size_t _Align, class _Alloc>
+static_any_vector<_N, _Align, _Alloc>::static_any_vector(static_any_vector&& other) noexcept :
+	slot_allocator(std::move(other.get_slot_allocator())),
+	__tags(std::move(other.__tags)),
+	__types(std::move(other.__types)),
+	__data(other.__data),
+	__capacity(other.__capacity)
+{
+	other.__tags.clear();
+	other.__types.clear();
+	other.__data = nullptr;
+	other.__capacity = 0;
+}
+
+template <std::size_t _N, std::size_t _Align, class _Alloc>
+static_any_vector<_N, _Align, _Alloc>::static_any_vector(static_any_vector&& other, const allocator_type& alloc) :
+	slot_allocator(alloc),
+	__tags(alloc),
+	__types(alloc)
+{
+	if (get_slot_allocator() == other.get_slot_allocator())
+		swap_storage(other);
+	else
+		relocate_from(other);
+}
+
+template <std::size_t _N, std::size_t _Align, class _Alloc>
+static_any_vector<_N, _Align, _Alloc>& static_any_vector<_N, _Align, _Alloc>::operator=(const static_any_vector& other)
+{
+	if (this != &other)
+	{
+		// copied with the allocator the vector ends up with, before anything is released
+		const bool propagate = slot_traits::propagate_on_container_copy_assignment::value;
+		static_any_vector temp(other, propagate ? other.get_allocator() : get_allocator());
+
+		release();
+		detail::static_any::assign_allocator(get_slot_allocator(), other.get_slot_allocator(),
+											 typename slot_traits::propagate_on_container_copy_assignment{});
+		take_storage(temp);
+	}
+	return *this;
+}
+
+template <std::size_t _N, std::size_t _Align, class _Alloc>
+static_any_vector<_N, _Align, _Alloc>& static_any_vector<_N, _Align, _Alloc>::operator=(static_any_vector&& other) noexcept(is_move_assignment_noexcept())
+{
+	if (this != &other)
+	{
+		// stolen with its allocator, or relocated to the storage of this vector if the allocators differ
+		const bool propagate = slot_traits::propagate_on_container_move_assignment::value;
+		static_any_vector temp = propagate ? static_any_vector(std::move(other)) : static_any_vector(std::move(other), get_allocator());
+
+		release();
+		detail::static_any::assign_allocator(get_slot_allocator(), std::move(temp.get_slot_allocator()),
+											 typename slot_traits::propagate_on_container_move_assignment{});
+		take_storage(temp);
+	}
+	return *this;
+}
+
+template <std::size_t _N, std::size_t _Align, class _Alloc>
+void static_any_vector<_N, _Align, _Alloc>::swap(static_any_vector& other) noexcept(is_swap_noexcept())
+{
+	if (slot_traits::propagate_on_container_swap::value || get_slot_allocator() == other.get_slot_allocator())
+	{
+		detail::static_any::swap_allocators(get_slot_allocator(), other.get_slot_allocator(),
+											typename slot_traits::propagate_on_container_swap{});
+		swap_storage(other);
+		return;
+	}
+
+	// each vector keeps its allocator: the elements are relocated to the storage of the other one
+	static_any_vector mine(std::move(*this), other.get_allocator());
+	static_any_vector theirs(std::move(other), get_allocator());
+	swap_storage(theirs);
+	other.swap_storage(mine);
+}
+
+template <std::size_t _N, std::size_t _Align, class _Alloc>
+void static_any_vector<_N, _Align, _Alloc>::swap_storage(static_any_vector& other) noexcept
+{
+	// the tags and types vectors follow the same propagation traits as the vector
+	__tags.swap(other.__tags);
+	__types.swap(other.__types);
+	std::swap(__data, other.__data);
+	std::swap(__capacity, other.__capacity);
+}
+
+template <std::size_t _N, std::size_t _Align, class _Alloc>
+void static_any_vector<_N, _Align, _Alloc>::release() noexcept
+{
+	clear();
+	deallocate(__data, __capacity);
+	__types.clear();
+	__data = nullptr;
+	__capacity = 0;
+}
+
+template <std::size_t _N, std::size_t _Align, class _Alloc>
+void static_any_vector<_N, _Align, _Alloc>::take_storage(static_any_vector& other)
+{
+	assert(__data == nullptr && get_slot_allocator() == other.get_slot_allocator());
+
+	// move assignments, as the tags and types vectors may keep their allocators
+	__tags = std::move(other.__tags);
+	__types = std::move(other.__types);
+	__data = other.__data;
+	__capacity = other.__capacity;
+
+	other.__tags.clear();
+	other.__types.clear();
+	other.__data = nullptr;
+	other.__capacity = 0;
+}
+
+template <std::size_t _N, std::size_t _Align, class _Alloc>
+void static_any_vector<_N, _Align, _Alloc>::relocate_from(static_any_vector& other)
+{
+	assert(empty() && __capacity == 0);
+
+	if (!other.empty())
+	{
+		__tags.reserve(other.size());
+		__types.reserve(other.__types.size());
+
+		slot* new_data = allocate(other.size());
+		try
+		{
+			other.relocate_to(new_data);
+		}
+		catch(...)
+		{
+			deallocate(new_data, other.size());
+			throw;
+		}
+
+		__data = new_data;
+		__capacity = other.size();
+		__tags.assign(other.__tags.begin(), other.__tags.end());
+		__types.assign(other.__types.begin(), other.__types.end());
+	}
+
+	other.deallocate(other.__data, other.__capacity);
+	other.__tags.clear();
+	other.__types.clear();
+	other.__data = nullptr;
+	other.__capacity = 0;
+}
+
+template <std::size_t _N, std::size_t _Align, class _Alloc>
+template <class _T, class>
+void static_any_vector<_N, _Align, _Alloc>::push_back(_T&& t)
+{
+	emplace_back<std::remove_cv_t<std::remove_reference_t<_T>>>(std::forward<_T>(t));
+}
+
+template <std::size_t _N, std::size_t _Align, class _Alloc>
+template <std::size_t _M, std::size_t _AlignM, class>
+void static_any_vector<_N, _Align, _Alloc>::push_back(const static_any<_M, _AlignM>& any)
+{
+	const vtable* vt = any.__vtable;
+
+	construct_back(vt, 1, [&](slot* first)
+	{
+		if (vt)
+			detail::static_any::copy_n(vt, first->data, any.__buff.data(), 1, vt->size);
+	});
+}
+
+template <std::size_t _N, std::size_t _Align, class _Alloc>
+template <class _T, class... Args>
+void static_any_vector<_N, _Align, _Alloc>::emplace_back(Args&&... args)
+{
+	static_assert(_N >= sizeof(_T), "_T is too big to be emplaced in static_any_vector");
+	static_assert(_Align >= alignof(_T), "_T is over-aligned for static_any_vector");
+
+	construct_back(detail::static_any::get_vtable_for_type<_T>(), 1, [&](slot* first)
+	{
+		new(first->data) _T(std::forward<Args>(args)...);
+	});
+}
+
+template <std::size_t _N, std::size_t _Align, class _Alloc>
+template <class _T>
+void static_any_vector<_N, _Align, _Alloc>::append(size_type count, const _T& value)
+{
+	static_assert(_N >= sizeof(_T), "_T is too big to be copied to static_any_vector");
+	static_assert(_Align >= alignof(_T), "_T is over-aligned for static_any_vector");
+
+	if (count == 0)
+		return;
+
+	const vtable* vt = detail::static_any::get_vtable_for_type<_T>();
+
+	construct_back(vt, count, [&](slot* first)
+	{
+		size_type i = 0;
+
+		try
+		{
+			for (; i < count; ++i)
+				new(first[i].data) _T(value);
+		}
+		catch(...)
+		{
+			detail::static_any::destroy_n(vt, first->data, i, stride);
+			throw;
+		}
+	});
+}
+
+template <std::size_t _N, std::size_t _Align, class _Alloc>
+template <class _InputIt, class>
+void static_any_vector<_N, _Align, _Alloc>::append(_InputIt first, _InputIt last)
+{
+	using category = typename std::iterator_traits<_InputIt>::iterator_category;
+
+	const size_type old_size = size();
+
+	try
+	{
+		if (std::is_base_of<std::forward_iterator_tag, category>::value)
+			grow(static_cast<size_type>(std::distance(first, last)));
+
+		for (; first != last; ++first)
+			push_back(*first);
+	}
+	catch(...)
+	{
+		destroy_runs(__data, old_size, size());
+		__tags.resize(old_size);
+		throw;
+	}
+}
+
+template <std::size_t _N, std::size_t _Align, class _Alloc>
+void static_any_vector<_N, _Align, _Alloc>::pop_back()
+{
+	assert(!empty());
+
+	detail::static_any::destroy_n(vtable_of(size() - 1), data(size() - 1), 1, stride);
+	__tags.pop_back();
+}
+
+template <std::size_t _N, std::size_t _Align, class _Alloc>
+void static_any_vector<_N, _Align, _Alloc>::clear()
+{
+	destroy_runs(__data, 0, size());
+	__tags.clear();
+}
+
+template <std::size_t _N, std::size_t _Align, class _Alloc>
+void static_any_vector<_N, _Align, _Alloc>::reserve(size_type capacity)
+{
+	if (capacity <= __capacity)
+		return;
+
+	__tags.reserve(capacity);
+
+	slot* new_data = allocate(capacity);
+	try
+	{
+		relocate_to(new_data);
+	}
+	catch(...)
+	{
+		deallocate(new_data, capacity);
+		throw;
+	}
+
+	deallocate(__data, __capacity);
+	__data = new_data;
+	__capacity = capacity;
+}
+
+template <std::size_t _N, std::size_t _Align, class _Alloc>
+template <class _T>
+bool static_any_vector<_N, _Align, _Alloc>::has(size_type i) const
+{
+	const vtable* vt = vtable_of(i);
+	return vt != nullptr && detail::static_any::has_type<_T>(vt);
+}
+
+template <std::size_t _N, std::size_t _Align, class _Alloc>
+template <class _T>
+const _T& static_any_vector<_N, _Align, _Alloc>::get(size_type i) const
+{
+	return const_cast<static_any_vector&>(*this).template get<_T>(i);
+}
+
+template <std::size_t _N, std::size_t _Align, class _Alloc>
+template <class _T>
+_T& static_any_vector<_N, _Align, _Alloc>::get(size_type i)
+{
+	if (!has<_T>(i))
+		throw bad_any_cast(type(i), static_any_typeid<_T>());
+
+	return *reinterpret_cast<_T*>(data(i));
+}
+
+template <std::size_t _N, std::size_t _Align, class _Alloc>
+template <class _T>
+const _T* static_any_vector<_N, _Align, _Alloc>::try_get(size_type i) const
+{
+	return const_cast<static_any_vector&>(*this).template try_get<_T>(i);
+}
+
+template <std::size_t _N, std::size_t _Align, class _Alloc>
+template <class _T>
+_T* static_any_vector<_N, _Align, _Alloc>::try_get(size_type i)
+{
+	return has<_T>(i) ? reinterpret_cast<_T*>(data(i)) : nullptr;
+}
+
+template <std::size_t _N, std::size_t _Align, class _Alloc>
+const static_any_type_info& static_any_vector<_N, _Align, _Alloc>::type(size_type i) const
+{
+	const vtable* vt = vtable_of(i);
+	return vt == nullptr ? static_any_typeid<void>() : *vt->type_info;
+}
+
+template <std::size_t _N, std::size_t _Align, class _Alloc>
+static_any_type_id_t static_any_vector<_N, _Align, _Alloc>::type_id(size_type i) const
+{
+	return detail::static_any::type_id(vtable_of(i));
+}
+
+template <std::size_t _N, std::size_t _Align, class _Alloc>
+template <class _T, class _F>
+void static_any_vector<_N, _Align, _Alloc>::for_each(_F&& f)
+{
+	const tag_type tag = find_tag<_T>();
+	if (tag == empty_tag)
+		return;
+
+	detail::static_any::for_each_tag(__tags.data(), size(), tag, [this, &f](size_type i)
+	{
+		f(*reinterpret_cast<_T*>(data(i)));
+	});
+}
+
+template <std::size_t _N, std::size_t _Align, class _Alloc>
+template <class _T, class _F>
+void static_any_vector<_N, _Align, _Alloc>::for_each(_F&& f) const
+{
+	const_cast<static_any_vector&>(*this).template for_each<_T>([&f](const _T& t) { f(t); });
+}
+
+template <std::size_t _N, std::size_t _Align, class _Alloc>
+template <class _T>
+typename static_any_vector<_N, _Align, _Alloc>::size_type static_any_vector<_N, _Align, _Alloc>::count() const
+{
+	const tag_type tag = find_tag<_T>();
+	if (tag == empty_tag)
+		return 0;
+
+	return detail::static_any::count_tags(__tags.data(), size(), tag);
+}
+
+template <std::size_t _N, std::size_t _Align, class _Alloc>
+template <class _T, class _OutputIt>
+_OutputIt static_any_vector<_N, _Align, _Alloc>::find_all(_OutputIt out) const
+{
+	const tag_type tag = find_tag<_T>();
+	if (tag == empty_tag)
+		return out;
+
+	detail::static_any::for_each_tag(__tags.data(), size(), tag, [&out](size_type i) { *out++ = i; });
+	return out;
+}
+
+template <std::size_t _N, std::size_t _Align, class _Alloc>
+template <class _T>
+typename static_any_vector<_N, _Align, _Alloc>::size_type static_any_vector<_N, _Align, _Alloc>::partition()
+{
+	const tag_type tag = find_tag<_T>();
+	if (tag == empty_tag)
+		return 0;
+
+	// the runs of consecutive elements holding a _T, then the runs of the others in between
+	vector<segment> matching(get_allocator());
+	vector<segment> others(get_allocator());
+	size_type count = 0;
+	size_type next = 0;
+
+	detail::static_any::for_each_tag(__tags.data(), size(), tag, [&](size_type i)
+	{
+		if (!matching.empty() && i == next)
+		{
+			++matching.back().count;
+		}
+		else
+		{
+			if (i != next)
+				others.push_back(segment{next, i - next, 0});
+			matching.push_back(segment{i, 1, count});
+		}
+		++count;
+		next = i + 1;
+	});
+
+	if (next != size())
+		others.push_back(segment{next, size() - next, 0});
+
+	// already partitioned
+	if (matching.size() == 1 && matching.front().first == 0)
+		return count;
+
+	size_type dst = count;
+	for (segment& s : others)
+	{
+		s.dst = dst;
+		dst += s.count;
+	}
+
+	matching.insert(matching.end(), others.begin(), others.end());
+
+	vector<tag_type> new_tags(size(), tag, get_allocator());
+	for (const segment& s : others)
+		std::copy(__tags.begin() + static_cast<std::ptrdiff_t>(s.first),
+				  __tags.begin() + static_cast<std::ptrdiff_t>(s.first + s.count),
+				  new_tags.begin() + static_cast<std::ptrdiff_t>(s.dst));
+	new_tags.reserve(__capacity);
+
+	slot* new_data = allocate(__capacity);
+	try
+	{
+		relocate_to(new_data, matching.data(), matching.size());
+	}
+	catch(...)
+	{
+		deallocate(new_data, __capacity);
+		throw;
+	}
+
+	deallocate(__data, __capacity);
+	__data = new_data;
+	__tags.swap(new_tags);
+	return count;
+}
+
+template <std::size_t _N, std::size_t _Align, class _Alloc>
+const detail::static_any::vtable* static_any_vector<_N, _Align, _Alloc>::vtable_of(size_type i) const
+{
+	const tag_type tag = __tags[i];
+	return tag == empty_tag ? nullptr : __types[tag - 1];
+}
+
+template <std::size_t _N, std::size_t _Align, class _Alloc>
+typename static_any_vector<_N, _Align, _Alloc>::tag_type static_any_vector<_N, _Align, _Alloc>::tag_for(const vtable* vt)
+{
+	if (vt == nullptr)
+		return empty_tag;
+
+	for (std::size_t i = 0; i < __types.size(); ++i)
+		if (__types[i] == vt)
+			return static_cast<tag_type>(i + 1);
+
+	// the same type may have several vtables, one per DLL
+	for (std::size_t i = 0; i < __types.size(); ++i)
+		if (detail::static_any::is_same_type(__types[i], vt))
+			return static_cast<tag_type>(i + 1);
+
+	if (__types.size() == std::numeric_limits<tag_type>::max())
+		throw std::length_error("static_any_vector: too many different types");
+
+	__types.push_back(vt);
+	return static_cast<tag_type>(__types.size());
+}
+
+template <std::size_t _N, std::size_t _Align, class _Alloc>
+template <class _T>
+typename static_any_vector<_N, _Align, _Alloc>::tag_type static_any_vector<_N, _Align, _Alloc>::find_tag() const
+{
+	for (std::size_t i = 0; i < __types.size(); ++i)
+		if (detail::static_any::has_type<_T>(__types[i]))
+			return static_cast<tag_type>(i + 1);
+
+	return empty_tag;
+}
+
+template <std::size_t _N, std::size_t _Align, class _Alloc>
+template <class _F>
+void static_any_vector<_N, _Align, _Alloc>::for_each_run(size_type first, size_type last, _F&& f) const
+{
+	while (first != last)
+	{
+		const tag_type tag = __tags[first];
+
+		size_type end = first + 1;
+		while (end != last && __tags[end] == tag)
+			++end;
+
+		if (tag != empty_tag)
+			f(__types[tag - 1], first, end - first);
+
+		first = end;
+	}
+}
+
+template <std::size_t _N, std::size_t _Align, class _Alloc>
+template <class _Entry>
+bool static_any_vector<_N, _Align, _Alloc>::all_trivial(_Entry vtable::*entry) const
+{
+	return std::all_of(__types.begin(), __types.end(), [entry](const vtable* vt) { return vt->*entry == nullptr; });
+}
+
+template <std::size_t _N, std::size_t _Align, class _Alloc>
+void static_any_vector<_N, _Align, _Alloc>::grow(size_type count)
+{
+	if (size() + count > __capacity)
+		reserve(std::max(size() + count, 2 * __capacity));
+}
+
+template <std::size_t _N, std::size_t _Align, class _Alloc>
+template <class _Construct>
+void static_any_vector<_N, _Align, _Alloc>::construct_back(const vtable* vt, size_type count, _Construct&& construct)
+{
+	const tag_type tag = tag_for(vt);
+
+	if (size() + count <= __capacity)
+	{
+		construct(__data + size());
+		__tags.insert(__tags.end(), count, tag);
+		return;
+	}
+
+	const size_type capacity = std::max(size() + count, 2 * __capacity);
+	__tags.reserve(capacity);
+
+	slot* new_data = allocate(capacity);
+	try
+	{
+		construct(new_data + size());
+	}
+	catch(...)
+	{
+		deallocate(new_data, capacity);
+		throw;
+	}
+
+	try
+	{
+		relocate_to(new_data);
+	}
+	catch(...)
+	{
+		if (vt)
+			detail::static_any::destroy_n(vt, new_data[size()].data, count, stride);
+		deallocate(new_data, capacity);
+		throw;
+	}
+
+	deallocate(__data, __capacity);
+	__data = new_data;
+	__capacity = capacity;
+	__tags.insert(__tags.end(), count, tag);
+}
+
+template <std::size_t _N, std::size_t _Align, class _Alloc>
+void static_any_vector<_N, _Align, _Alloc>::copy_to(slot* dst) const
+{
+	size_type copied = 0;
+
+	try
+	{
+		for_each_run(0, size(), [&](const vtable* vt, size_type first, size_type count)
+		{
+			detail::static_any::copy_n(vt, dst[first].data, __data[first].data, count, stride);
+			copied = first + count;
+		});
+	}
+	catch(...)
+	{
+		destroy_runs(dst, 0, copied);
+		throw;
+	}
+}
+
+template <std::size_t _N, std::size_t _Align, class _Alloc>
+void static_any_vector<_N, _Align, _Alloc>::relocate_to(slot* dst)
+{
+	const segment all = {0, size(), 0};
+	relocate_to(dst, &all, 1);
+}
+
+template <std::size_t _N, std::size_t _Align, class _Alloc>
+void static_any_vector<_N, _Align, _Alloc>::relocate_to(slot* dst, const segment* segments, size_type count)
+{
+	if (empty())
+		return;
+
+	// strong guarantee: the types which may throw on move are copied first, and the old elements are
+	// destroyed only once all the new ones are constructed
+	size_type done = 0;
+	size_type copied = 0;
+
+	try
+	{
+		for (; done < count; ++done)
+		{
+			const segment& s = segments[done];
+			copied = s.first;
+
+			for_each_run(s.first, s.first + s.count, [&](const vtable* vt, size_type first, size_type n)
+			{
+				if (!detail::static_any::relocate_by_move(vt))
+				{
+					detail::static_any::copy_n(vt, dst[s.dst + first - s.first].data, __data[first].data, n, stride);
+					copied = first + n;
+				}
+			});
+		}
+	}
+	catch(...)
+	{
+		for (size_type i = 0; i <= done; ++i)
+		{
+			const segment& s = segments[i];
+
+			for_each_run(s.first, i == done ? copied : s.first + s.count, [&](const vtable* vt, size_type first, size_type n)
+			{
+				if (!detail::static_any::relocate_by_move(vt))
+					detail::static_any::destroy_n(vt, dst[s.dst + first - s.first].data, n, stride);
+			});
+		}
+		throw;
+	}
+
+	const bool trivial = all_trivial(&vtable::move_n);
+
+	for (size_type i = 0; i < count; ++i)
+	{
+		const segment& s = segments[i];
+
+		if (trivial)
+		{
+			std::memcpy(dst + s.dst, __data + s.first, s.count * stride);
+		}
+		else
+		{
+			for_each_run(s.first, s.first + s.count, [&](const vtable* vt, size_type first, size_type n)
+			{
+				if (detail::static_any::relocate_by_move(vt))
+					detail::static_any::move_n(vt, dst[s.dst + first - s.first].data, __data[first].data, n, stride);
+			});
+		}
+	}
+
+	destroy_runs(__data, 0, size());
+}
+
+template <std::size_t _N, std::size_t _Align, class _Alloc>
+void static_any_vector<_N, _Align, _Alloc>::destroy_runs(slot* first, size_type begin, size_type end) const
+{
+	if (all_trivial(&vtable::destroy_n))
+		return;
+
+	for_each_run(begin, end, [&](const vtable* vt, size_type run, size_type count)
+	{
+		detail::static_any::destroy_n(vt, first[run].data, count, stride);
+	});
+}
+
+template <std::size_t _N, std::size_t _Align, class _Alloc>
+typename static_any_vector<_N, _Align, _Alloc>::slot* static_any_vector<_N, _Align, _Alloc>::allocate(size_type capacity)
+{
+	if (capacity > slot_traits::max_size(get_slot_allocator()))
+		throw std::length_error("static_any_vector: capacity is too big");
+
+	return slot_traits::allocate(get_slot_allocator(), capacity);
+}
+
+template <std::size_t _N, std::size_t _Align, class _Alloc>
+void static_any_vector<_N, _Align, _Alloc>::deallocate(slot* p, size_type capacity)
+{
+	if (p)
+		slot_traits::deallocate(get_slot_allocator(), p, capacity);
+}
+
+template <std::size_t _N, std::size_t _Align, class _Alloc>
+inline void swap(static_any_vector<_N, _Align, _Alloc>& lhs, static_any_vector<_N, _Align, _Alloc>& rhs) noexcept
+{
+	lhs.swap(rhs);
+}
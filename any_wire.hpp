@@ -0,0 +1,129 @@
+#pragma once
+
+#include "any_core.hpp"
+
+#include <cstdint>
+#include <cstring>
+
+// Wire format of an array of trivially copyable values -- typically static_any_tagged_t: a header followed by
+// the values, as they lie in memory. There is no per-value encoding, hence both ends have to share the
+// architecture (size, alignment and endianness of the values) and the type ids.
+struct static_any_wire_header
+{
+	static constexpr std::uint32_t magic_value = 0x53414E59; // "SANY"
+
+	std::uint32_t magic;
+	std::uint32_t value_size;
+	std::uint32_t value_alignment;
+	std::uint32_t reserved;
+	std::uint64_t count;
+};
+
+namespace detail { namespace static_any {
+
+constexpr std::size_t align_up(std::size_t size, std::size_t align)
+{
+	return (size + align - 1) / align * align;
+}
+
+// the values are aligned in the buffer, so that they can be read in place
+template <class _Any>
+constexpr std::size_t wire_values_offset()
+{
+	return align_up(sizeof(static_any_wire_header), alignof(_Any));
+}
+
+// std::uint64_t and std::size_t are the same type on 64 bits platforms, where a cast would be useless
+template <class _T>
+constexpr std::size_t to_size(_T value)
+{
+	return static_cast<std::size_t>(value);
+}
+
+template <class _Any>
+inline bool is_valid_wire_header(const void* buffer, std::size_t size, std::size_t& count)
+{
+	if (size < wire_values_offset<_Any>())
+		return false;
+
+	static_any_wire_header header;
+	std::memcpy(&header, buffer, sizeof(header));
+
+	if (header.magic != static_any_wire_header::magic_value ||
+		header.value_size != sizeof(_Any) ||
+		header.value_alignment != alignof(_Any) ||
+		header.count > (size - wire_values_offset<_Any>()) / sizeof(_Any))
+		return false;
+
+	count = to_size(header.count);
+	return true;
+}
+
+}}
+
+// Size of the buffer needed to serialize count values.
+template <class _Any>
+constexpr std::size_t serialized_size(std::size_t count)
+{
+	return detail::static_any::wire_values_offset<_Any>() + count * sizeof(_Any);
+}
+
+// Writes the header and the count values to the buffer with a single memcpy. Returns the number of bytes
+// written, or 0 if the buffer is too small.
+template <class _Any>
+inline std::size_t serialize(const _Any* values, std::size_t count, void* buffer, std::size_t size)
+{
+	static_assert(detail::static_any::is_trivially_copyable<_Any>::value, "_Any is not trivially copyable");
+
+	const std::size_t needed = serialized_size<_Any>(count);
+	if (size < needed)
+		return 0;
+
+	static_any_wire_header header = {};
+	header.magic = static_any_wire_header::magic_value;
+	header.value_size = static_cast<std::uint32_t>(sizeof(_Any));
+	header.value_alignment = static_cast<std::uint32_t>(alignof(_Any));
+	header.count = count;
+
+	char* out = static_cast<char*>(buffer);
+	std::memset(out, 0, detail::static_any::wire_values_offset<_Any>());
+	std::memcpy(out, &header, sizeof(header));
+
+	if (count != 0)
+		std::memcpy(out + detail::static_any::wire_values_offset<_Any>(), values, count * sizeof(_Any));
+
+	return needed;
+}
+
+// Zero-copy read: returns a pointer to the values lying in the buffer, and sets count. Returns nullptr if
+// the buffer does not hold values of type _Any, is truncated, or is not aligned for _Any -- a mmaped file
+// or a ring buffer of aligned records always is.
+template <class _Any>
+inline const _Any* deserialize_view(const void* buffer, std::size_t size, std::size_t& count)
+{
+	static_assert(detail::static_any::is_trivially_copyable<_Any>::value, "_Any is not trivially copyable");
+
+	if (reinterpret_cast<std::uintptr_t>(buffer) % alignof(_Any) != 0 ||
+		!detail::static_any::is_valid_wire_header<_Any>(buffer, size, count))
+		return nullptr;
+
+	return reinterpret_cast<const _Any*>(static_cast<const char*>(buffer) + detail::static_any::wire_values_offset<_Any>());
+}
+
+// Copies up to max_count values from the buffer, which does not need to be aligned. Returns the number of
+// values copied, 0 if the buffer does not hold values of type _Any.
+template <class _Any>
+inline std::size_t deserialize(const void* buffer, std::size_t size, _Any* values, std::size_t max_count)
+{
+	static_assert(detail::static_any::is_trivially_copyable<_Any>::value, "_Any is not trivially copyable");
+
+	std::size_t count;
+	if (!detail::static_any::is_valid_wire_header<_Any>(buffer, size, count))
+		return 0;
+
+	count = count < max_count ? count : max_count;
+	if (count != 0)
+		std::memcpy(values, static_cast<const char*>(buffer) + detail::static_any::wire_values_offset<_Any>(), count * sizeof(_Any));
+
+	return count;
+}
@@ -52,6 +52,39 @@ int main()
 		a = .2342;
 	});
 
+	static_any<8> rsda = .1234;
+	static_any<32> rssa = small_struct{1, nullptr, .12};
+	static_any<32> rsstr = small_struct{1, nullptr, .12};
+
+	s.add("static_any<8> double reassignment", [&rsda]()
+	{
+		rsda = .2342;
+	});
+	s.add("static_any<32> small_struct reassignment", [&rssa]()
+	{
+		rssa = small_struct{2, nullptr, .45};
+	});
+	s.add("static_any<32> any to any reassignment", [&rssa, &rsstr]()
+	{
+		rsstr = rssa;
+	});
+
+	static_any<32> msstr = std::string("foobar");
+
+	s.add("static_any<32> small_struct move construction", [&rssa]()
+	{
+		static_any<32> a = std::move(rssa);
+	});
+	s.add("static_any<32> string move construction", [&msstr]()
+	{
+		static_any<32> a = std::move(msstr);
+	});
+	s.add("static_any<32> small_struct destroy", []()
+	{
+		static_any<32> a = small_struct{2, nullptr, .45};
+		a.reset();
+	});
+
 	double d = .42;
 
 	QVariant qd = d;
@@ -0,0 +1,118 @@
+#include "../any_coroutine.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <any>
+#include <future>
+#include <string>
+
+// Cost of handing a result to a consumer: static_any_channel and static_any_future, against a std::promise of a
+// std::any -- a shared state and, for the values too big for the small buffer of std::any, a value allocated
+// per result. Everything runs on one thread, so only the cost of the hand-off is measured.
+
+namespace {
+
+struct big_value
+{
+	double values[4];
+};
+
+template <class _T>
+_T make_value();
+
+template <> double make_value<double>() { return .42; }
+template <> std::string make_value<std::string>() { return std::string("foobar"); }
+template <> big_value make_value<big_value>() { return big_value{{1., 2., 3., 4.}}; }
+
+// coroutine started on call, and destroyed when it returns
+struct detached
+{
+	struct promise_type
+	{
+		detached get_return_object() { return {}; }
+		std::suspend_never initial_suspend() noexcept { return {}; }
+		std::suspend_never final_suspend() noexcept { return {}; }
+		void return_void() {}
+		void unhandled_exception() { std::terminate(); }
+	};
+};
+
+template <class _T>
+void promise_any(benchmark::State& state)
+{
+	const _T t = make_value<_T>();
+
+	for (auto _ : state)
+	{
+		std::promise<std::any> promise;
+		std::future<std::any> future = promise.get_future();
+		promise.set_value(t);
+
+		_T value = std::any_cast<_T>(future.get());
+		benchmark::DoNotOptimize(value);
+	}
+}
+
+BENCHMARK_TEMPLATE(promise_any, double);
+BENCHMARK_TEMPLATE(promise_any, std::string);
+BENCHMARK_TEMPLATE(promise_any, big_value);
+
+// a consumer waits on the channel, and is resumed by each value sent
+template <class _T>
+void channel(benchmark::State& state)
+{
+	static_any_channel<64> channel;
+	bool stop = false;
+
+	auto consumer = [&channel, &stop]() -> detached
+	{
+		while (!stop)
+		{
+			_T value = co_await channel.template receive<_T>();
+			benchmark::DoNotOptimize(value);
+		}
+	};
+	consumer();
+
+	const _T t = make_value<_T>();
+	for (auto _ : state)
+		channel.send(t);
+
+	stop = true;
+	channel.send(t);
+}
+
+BENCHMARK_TEMPLATE(channel, double);
+BENCHMARK_TEMPLATE(channel, std::string);
+BENCHMARK_TEMPLATE(channel, big_value);
+
+template <class _T>
+static_any_future<64> produce(const _T& t)
+{
+	co_return t;
+}
+
+// a coroutine per result, which frame may be allocated unless the compiler elides it
+template <class _T>
+void future(benchmark::State& state)
+{
+	const _T t = make_value<_T>();
+
+	auto consumer = [&state, &t]() -> detached
+	{
+		for (auto _ : state)
+		{
+			_T value = any_cast<_T>(co_await produce(t));
+			benchmark::DoNotOptimize(value);
+		}
+	};
+	consumer();
+}
+
+BENCHMARK_TEMPLATE(future, double);
+BENCHMARK_TEMPLATE(future, std::string);
+BENCHMARK_TEMPLATE(future, big_value);
+
+}
+
+BENCHMARK_MAIN();
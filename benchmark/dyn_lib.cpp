@@ -0,0 +1,12 @@
+#include "dyn_lib.hpp"
+
+static_any<16> make_static_any_with_int(int x)
+{
+	static_any<16> a = x;
+	return a;
+}
+
+std::any make_std_any_with_int(int x)
+{
+	return std::any(x);
+}
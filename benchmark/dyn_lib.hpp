@@ -0,0 +1,9 @@
+#pragma once
+
+#include "../any.hpp"
+
+#include <any>
+
+static_any<16> make_static_any_with_int(int x);
+
+std::any make_std_any_with_int(int x);
@@ -0,0 +1,127 @@
+#include "../any_queue.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Throughput and round trip latency of spsc_any_queue and mpsc_any_queue, against a std::deque of static_any
+// behind a mutex. The threaded benchmarks are only meaningful with as many cores as threads.
+
+namespace {
+
+using value_t = static_any<64>;
+
+// same interface as the lock-free queues
+class locked_queue
+{
+public:
+	explicit locked_queue(std::size_t capacity) : __capacity(capacity) {}
+
+	template <class _T>
+	bool try_push(_T&& t)
+	{
+		std::lock_guard<std::mutex> lock(__mutex);
+		if (__values.size() == __capacity)
+			return false;
+		__values.emplace_back(std::forward<_T>(t));
+		return true;
+	}
+
+	bool try_pop(value_t& value)
+	{
+		std::lock_guard<std::mutex> lock(__mutex);
+		if (__values.empty())
+			return false;
+		value = std::move(__values.front());
+		__values.pop_front();
+		return true;
+	}
+
+private:
+	std::mutex __mutex;
+	std::deque<value_t> __values;
+	const std::size_t __capacity;
+};
+
+template <class _T>
+_T make_value();
+
+template <> double make_value<double>() { return .42; }
+template <> std::string make_value<std::string>() { return std::string("foobar"); }
+
+// push and pop from the same thread: cost of an operation without contention
+template <class _Queue, class _T>
+void queue_round_trip(benchmark::State& state)
+{
+	_Queue q(1024);
+	const _T t = make_value<_T>();
+	value_t value;
+
+	for (auto _ : state)
+	{
+		q.try_push(t);
+		q.try_pop(value);
+		benchmark::DoNotOptimize(value);
+	}
+}
+
+BENCHMARK_TEMPLATE(queue_round_trip, spsc_any_queue<64>, double);
+BENCHMARK_TEMPLATE(queue_round_trip, mpsc_any_queue<64>, double);
+BENCHMARK_TEMPLATE(queue_round_trip, locked_queue, double);
+BENCHMARK_TEMPLATE(queue_round_trip, spsc_any_queue<64>, std::string);
+BENCHMARK_TEMPLATE(queue_round_trip, mpsc_any_queue<64>, std::string);
+BENCHMARK_TEMPLATE(queue_round_trip, locked_queue, std::string);
+
+// range(0) producer threads push values until stopped, items processed are the values popped by the consumer
+template <class _Queue, class _T>
+void queue_throughput(benchmark::State& state)
+{
+	_Queue q(1024);
+	std::atomic<bool> stop{false};
+
+	std::vector<std::thread> producers;
+	for (int64_t i = 0; i < state.range(0); ++i)
+	{
+		producers.emplace_back([&q, &stop]()
+		{
+			const _T t = make_value<_T>();
+			while (!stop.load(std::memory_order_relaxed))
+			{
+				if (!q.try_push(t))
+					std::this_thread::yield();
+			}
+		});
+	}
+
+	value_t value;
+	for (auto _ : state)
+	{
+		while (!q.try_pop(value))
+			std::this_thread::yield();
+		benchmark::DoNotOptimize(value);
+	}
+
+	stop = true;
+	for (std::thread& producer : producers)
+		producer.join();
+
+	state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK_TEMPLATE(queue_throughput, spsc_any_queue<64>, double)->Arg(1)->UseRealTime();
+BENCHMARK_TEMPLATE(queue_throughput, locked_queue, double)->Arg(1)->UseRealTime();
+BENCHMARK_TEMPLATE(queue_throughput, spsc_any_queue<64>, std::string)->Arg(1)->UseRealTime();
+BENCHMARK_TEMPLATE(queue_throughput, locked_queue, std::string)->Arg(1)->UseRealTime();
+BENCHMARK_TEMPLATE(queue_throughput, mpsc_any_queue<64>, double)->Arg(1)->Arg(2)->Arg(4)->UseRealTime();
+BENCHMARK_TEMPLATE(queue_throughput, locked_queue, double)->Arg(2)->Arg(4)->UseRealTime();
+BENCHMARK_TEMPLATE(queue_throughput, mpsc_any_queue<64>, std::string)->Arg(1)->Arg(2)->Arg(4)->UseRealTime();
+BENCHMARK_TEMPLATE(queue_throughput, locked_queue, std::string)->Arg(2)->Arg(4)->UseRealTime();
+
+}
+
+BENCHMARK_MAIN();
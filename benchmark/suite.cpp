@@ -0,0 +1,352 @@
+#include "../any.hpp"
+#include "dyn_lib.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <any>
+#include <array>
+#include <cstring>
+#include <string>
+#include <variant>
+#include <vector>
+
+// Run with --benchmark_format=json (or --benchmark_out=<file> --benchmark_out_format=json) to track
+// regressions. Cycles, instructions and branch misses are reported as counters when Google Benchmark
+// has been built with libpfm, and when the process is allowed to read the performance counters.
+
+namespace {
+
+struct small_struct
+{
+	int i;
+	void* v;
+	double d;
+
+	int h() const { return i; }
+};
+
+using variant_t = std::variant<std::monostate, int, double, small_struct, std::string>;
+
+template <class _T>
+_T make_value();
+
+template <> double make_value<double>() { return .42; }
+template <> small_struct make_value<small_struct>() { return small_struct{2, nullptr, .45}; }
+template <> std::string make_value<std::string>() { return std::string("foobar"); }
+
+// copy / move construction
+
+template <class _Any, class _T>
+void copy_construction(benchmark::State& state)
+{
+	const _Any a = make_value<_T>();
+	for (auto _ : state)
+	{
+		_Any b = a;
+		benchmark::DoNotOptimize(b);
+	}
+}
+
+template <class _Any, class _T>
+void move_construction(benchmark::State& state)
+{
+	_Any a = make_value<_T>();
+	for (auto _ : state)
+	{
+		_Any b = std::move(a);
+		benchmark::DoNotOptimize(b);
+		a = std::move(b);
+	}
+}
+
+BENCHMARK_TEMPLATE(copy_construction, static_any<32>, double);
+BENCHMARK_TEMPLATE(copy_construction, std::any, double);
+BENCHMARK_TEMPLATE(copy_construction, variant_t, double);
+BENCHMARK_TEMPLATE(copy_construction, static_any<32>, small_struct);
+BENCHMARK_TEMPLATE(copy_construction, std::any, small_struct);
+BENCHMARK_TEMPLATE(copy_construction, variant_t, small_struct);
+BENCHMARK_TEMPLATE(copy_construction, static_any<32>, std::string);
+BENCHMARK_TEMPLATE(copy_construction, std::any, std::string);
+BENCHMARK_TEMPLATE(copy_construction, variant_t, std::string);
+
+BENCHMARK_TEMPLATE(move_construction, static_any<32>, small_struct);
+BENCHMARK_TEMPLATE(move_construction, std::any, small_struct);
+BENCHMARK_TEMPLATE(move_construction, variant_t, small_struct);
+BENCHMARK_TEMPLATE(move_construction, static_any<32>, std::string);
+BENCHMARK_TEMPLATE(move_construction, std::any, std::string);
+BENCHMARK_TEMPLATE(move_construction, variant_t, std::string);
+
+// any to any assignment, from a smaller static_any
+
+template <std::size_t _From, std::size_t _To>
+void any_to_any_assignment(benchmark::State& state)
+{
+	const static_any<_From> from = make_value<double>();
+	static_any<_To> to = 1;
+	for (auto _ : state)
+	{
+		to = from;
+		benchmark::DoNotOptimize(to);
+	}
+}
+
+BENCHMARK_TEMPLATE(any_to_any_assignment, 8, 8);
+BENCHMARK_TEMPLATE(any_to_any_assignment, 8, 16);
+BENCHMARK_TEMPLATE(any_to_any_assignment, 8, 32);
+BENCHMARK_TEMPLATE(any_to_any_assignment, 8, 64);
+BENCHMARK_TEMPLATE(any_to_any_assignment, 32, 64);
+BENCHMARK_TEMPLATE(any_to_any_assignment, 64, 64);
+
+// type checks
+
+void static_any_has_hit(benchmark::State& state)
+{
+	const static_any<32> a = make_value<double>();
+	for (auto _ : state)
+		benchmark::DoNotOptimize(a.has<double>());
+}
+
+void static_any_has_miss(benchmark::State& state)
+{
+	const static_any<32> a = make_value<double>();
+	for (auto _ : state)
+		benchmark::DoNotOptimize(a.has<int>());
+}
+
+void std_any_type_hit(benchmark::State& state)
+{
+	const std::any a = make_value<double>();
+	for (auto _ : state)
+		benchmark::DoNotOptimize(std::any_cast<double>(&a) != nullptr);
+}
+
+void std_any_type_miss(benchmark::State& state)
+{
+	const std::any a = make_value<double>();
+	for (auto _ : state)
+		benchmark::DoNotOptimize(std::any_cast<int>(&a) != nullptr);
+}
+
+void variant_holds_hit(benchmark::State& state)
+{
+	const variant_t v = make_value<double>();
+	for (auto _ : state)
+		benchmark::DoNotOptimize(std::holds_alternative<double>(v));
+}
+
+void variant_holds_miss(benchmark::State& state)
+{
+	const variant_t v = make_value<double>();
+	for (auto _ : state)
+		benchmark::DoNotOptimize(std::holds_alternative<int>(v));
+}
+
+BENCHMARK(static_any_has_hit);
+BENCHMARK(static_any_has_miss);
+BENCHMARK(std_any_type_hit);
+BENCHMARK(std_any_type_miss);
+BENCHMARK(variant_holds_hit);
+BENCHMARK(variant_holds_miss);
+
+// type checks on values created in a shared library
+
+void static_any_has_hit_across_dll(benchmark::State& state)
+{
+	const static_any<16> a = make_static_any_with_int(7);
+	for (auto _ : state)
+		benchmark::DoNotOptimize(a.has<int>());
+}
+
+void static_any_has_miss_across_dll(benchmark::State& state)
+{
+	const static_any<16> a = make_static_any_with_int(7);
+	for (auto _ : state)
+		benchmark::DoNotOptimize(a.has<double>());
+}
+
+void std_any_type_hit_across_dll(benchmark::State& state)
+{
+	const std::any a = make_std_any_with_int(7);
+	for (auto _ : state)
+		benchmark::DoNotOptimize(std::any_cast<int>(&a) != nullptr);
+}
+
+void std_any_type_miss_across_dll(benchmark::State& state)
+{
+	const std::any a = make_std_any_with_int(7);
+	for (auto _ : state)
+		benchmark::DoNotOptimize(std::any_cast<double>(&a) != nullptr);
+}
+
+BENCHMARK(static_any_has_hit_across_dll);
+BENCHMARK(static_any_has_miss_across_dll);
+BENCHMARK(std_any_type_hit_across_dll);
+BENCHMARK(std_any_type_miss_across_dll);
+
+// emplace
+
+void static_any_emplace(benchmark::State& state)
+{
+	static_any<32> a;
+	for (auto _ : state)
+	{
+		a.emplace<small_struct>(small_struct{2, nullptr, .45});
+		benchmark::DoNotOptimize(a);
+	}
+}
+
+void std_any_emplace(benchmark::State& state)
+{
+	std::any a;
+	for (auto _ : state)
+	{
+		a.emplace<small_struct>(small_struct{2, nullptr, .45});
+		benchmark::DoNotOptimize(a);
+	}
+}
+
+void variant_emplace(benchmark::State& state)
+{
+	variant_t v;
+	for (auto _ : state)
+	{
+		v.emplace<small_struct>(small_struct{2, nullptr, .45});
+		benchmark::DoNotOptimize(v);
+	}
+}
+
+BENCHMARK(static_any_emplace);
+BENCHMARK(std_any_emplace);
+BENCHMARK(variant_emplace);
+
+// destroy
+
+template <class _Any, class _T>
+void destroy(benchmark::State& state)
+{
+	for (auto _ : state)
+	{
+		state.PauseTiming();
+		std::array<_Any, 64> values;
+		for (auto& value : values)
+			value = make_value<_T>();
+		state.ResumeTiming();
+
+		for (auto& value : values)
+			value = _Any();
+		benchmark::DoNotOptimize(values);
+	}
+}
+
+BENCHMARK_TEMPLATE(destroy, static_any<32>, small_struct);
+BENCHMARK_TEMPLATE(destroy, std::any, small_struct);
+BENCHMARK_TEMPLATE(destroy, variant_t, small_struct);
+BENCHMARK_TEMPLATE(destroy, static_any<32>, std::string);
+BENCHMARK_TEMPLATE(destroy, std::any, std::string);
+BENCHMARK_TEMPLATE(destroy, variant_t, std::string);
+
+// containers
+
+template <class _Any>
+void push_back(std::vector<_Any>& values, std::size_t i)
+{
+	switch (i % 3)
+	{
+	case 0: values.push_back(make_value<double>()); break;
+	case 1: values.push_back(make_value<small_struct>()); break;
+	default: values.push_back(static_cast<int>(i)); break;
+	}
+}
+
+template <class _Any>
+void vector_fill(benchmark::State& state)
+{
+	const auto count = static_cast<std::size_t>(state.range(0));
+	for (auto _ : state)
+	{
+		std::vector<_Any> values;
+		for (std::size_t i = 0; i < count; ++i)
+			push_back(values, i);
+		benchmark::DoNotOptimize(values.data());
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK_TEMPLATE(vector_fill, static_any<32>)->Arg(1024);
+BENCHMARK_TEMPLATE(vector_fill, std::any)->Arg(1024);
+BENCHMARK_TEMPLATE(vector_fill, variant_t)->Arg(1024);
+
+int sum_of(const static_any<32>& a)
+{
+	if (const int* i = a.try_get<int>())
+		return *i;
+	if (const small_struct* s = a.try_get<small_struct>())
+		return s->h();
+	return 0;
+}
+
+int sum_of(const std::any& a)
+{
+	if (const int* i = std::any_cast<int>(&a))
+		return *i;
+	if (const small_struct* s = std::any_cast<small_struct>(&a))
+		return s->h();
+	return 0;
+}
+
+int sum_of(const variant_t& v)
+{
+	if (const int* i = std::get_if<int>(&v))
+		return *i;
+	if (const small_struct* s = std::get_if<small_struct>(&v))
+		return s->h();
+	return 0;
+}
+
+template <class _Any>
+void vector_scan(benchmark::State& state)
+{
+	const auto count = static_cast<std::size_t>(state.range(0));
+	std::vector<_Any> values;
+	for (std::size_t i = 0; i < count; ++i)
+		push_back(values, i);
+
+	for (auto _ : state)
+	{
+		int sum = 0;
+		for (const auto& value : values)
+			sum += sum_of(value);
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK_TEMPLATE(vector_scan, static_any<32>)->Arg(1024);
+BENCHMARK_TEMPLATE(vector_scan, std::any)->Arg(1024);
+BENCHMARK_TEMPLATE(vector_scan, variant_t)->Arg(1024);
+
+}
+
+int main(int argc, char** argv)
+{
+	// report hardware counters by default, unless other ones are requested
+	static char perf_counters[] = "--benchmark_perf_counters=CYCLES,INSTRUCTIONS,BRANCH-MISSES";
+	const char* perf_counters_flag = "--benchmark_perf_counters";
+
+	std::vector<char*> args(argv, argv + argc);
+	bool has_perf_counters = false;
+	for (char* arg : args)
+		has_perf_counters |= std::strncmp(arg, perf_counters_flag, std::strlen(perf_counters_flag)) == 0;
+
+	if (!has_perf_counters)
+		args.push_back(perf_counters);
+
+	int args_count = static_cast<int>(args.size());
+	benchmark::Initialize(&args_count, args.data());
+	if (benchmark::ReportUnrecognizedArguments(args_count, args.data()))
+		return 1;
+
+	benchmark::RunSpecifiedBenchmarks();
+	benchmark::Shutdown();
+	return 0;
+}
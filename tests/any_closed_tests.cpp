@@ -0,0 +1,151 @@
+#include "../any_closed.hpp"
+#include "../any_compare.hpp"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+
+namespace {
+
+struct Counted
+{
+	Counted() { ++constructions; }
+	Counted(const Counted&) { ++copies; }
+	Counted(Counted&&) noexcept { ++moves; }
+	~Counted() { ++destructions; }
+
+	static void reset_counters() { constructions = copies = moves = destructions = 0; }
+
+	static int constructions;
+	static int copies;
+	static int moves;
+	static int destructions;
+};
+
+int Counted::constructions = 0;
+int Counted::copies = 0;
+int Counted::moves = 0;
+int Counted::destructions = 0;
+
+struct ThrowingCopy
+{
+	ThrowingCopy() = default;
+	ThrowingCopy(const ThrowingCopy&) { throw std::runtime_error("copy"); }
+	ThrowingCopy(ThrowingCopy&&) noexcept = default;
+};
+
+struct Large
+{
+	char data[40];
+};
+
+}
+
+TEST(any_for, size)
+{
+	static_assert(static_any_for<int, double, Large>::capacity() == sizeof(Large), "largest type");
+	static_assert(static_any_for<int, double, Large>::alignment() == alignof(double), "most aligned type");
+	static_assert(static_any_for<char, short>::capacity() == 2, "largest type");
+
+	static_any_for<int, std::string> a = std::string("foo");
+	ASSERT_EQ("foo", a.get<std::string>());
+	a = 1;
+	ASSERT_EQ(1, a.get<int>());
+}
+
+TEST(any_closed, size)
+{
+	static_assert(sizeof(static_closed_any<int, float>) == 8, "one byte index");
+	static_assert(sizeof(static_closed_any<char>) == 2, "one byte index");
+	static_assert(sizeof(static_closed_any<double, Large>) == 48, "one byte index");
+	static_assert(static_closed_any<int, double>::alignment() == alignof(double), "most aligned type");
+}
+
+TEST(any_closed, get)
+{
+	static_closed_any<int, double, std::string> a;
+	ASSERT_TRUE(a.empty());
+	ASSERT_EQ(a.npos, a.index());
+	ASSERT_EQ(typeid(void), a.type());
+	ASSERT_EQ(static_any_type_id<void>::value, a.type_id());
+
+	a = 2.5;
+	ASSERT_TRUE(a.has<double>());
+	ASSERT_FALSE(a.has<int>());
+	ASSERT_EQ(1u, a.index());
+	ASSERT_EQ(2.5, a.get<double>());
+	ASSERT_EQ(typeid(double), a.type());
+	ASSERT_EQ(static_any_type_id<double>::value, a.type_id());
+	ASSERT_THROW(a.get<int>(), bad_any_cast);
+	ASSERT_EQ(nullptr, a.try_get<std::string>());
+
+	a = std::string("foo");
+	const auto& ca = a;
+	ASSERT_EQ("foo", ca.get<std::string>());
+	ASSERT_EQ("foo", *ca.try_get<std::string>());
+
+	a.emplace<std::string>(3u, 'a');
+	ASSERT_EQ("aaa", a.get<std::string>());
+
+	a.reset();
+	ASSERT_TRUE(a.empty());
+}
+
+TEST(any_closed, visit)
+{
+	static_closed_any<int, std::string> a = 42;
+
+	int visited = 0;
+	ASSERT_TRUE(visit(a, [&visited](const auto& value) { visited += sizeof(value) == sizeof(int) ? 1 : 10; }));
+	ASSERT_EQ(1, visited);
+
+	a = std::string("foo");
+	ASSERT_TRUE(a.visit([](auto& value) { value = std::decay_t<decltype(value)>(); }));
+	ASSERT_EQ("", a.get<std::string>());
+
+	a.reset();
+	ASSERT_FALSE(visit(a, [](const auto&) {}));
+}
+
+TEST(any_closed, lifetime)
+{
+	Counted::reset_counters();
+	{
+		static_closed_any<int, Counted> a;
+		a.emplace<Counted>();
+
+		static_closed_any<int, Counted> b(a);
+		static_closed_any<int, Counted> c(std::move(b));
+		ASSERT_EQ(1, Counted::copies);
+		ASSERT_EQ(1, Counted::moves);
+
+		c = 1;
+		ASSERT_EQ(1, Counted::destructions);
+
+		c = a;
+		c = std::move(a);
+		ASSERT_TRUE(c.has<Counted>());
+	}
+	ASSERT_EQ(Counted::constructions + Counted::copies + Counted::moves, Counted::destructions);
+}
+
+TEST(any_closed, copy_strong_guarantee)
+{
+	static_closed_any<int, ThrowingCopy> a;
+	a.emplace<ThrowingCopy>();
+
+	static_closed_any<int, ThrowingCopy> b = 1;
+	ASSERT_THROW(b = a, std::runtime_error);
+	ASSERT_EQ(1, b.get<int>());
+}
+
+TEST(any_closed, move_only)
+{
+	using Closed = static_closed_any<int, std::unique_ptr<int>>;
+
+	Closed a = std::unique_ptr<int>(new int(3));
+	Closed b = std::move(a);
+	ASSERT_EQ(3, *b.get<std::unique_ptr<int>>());
+	ASSERT_THROW(Closed{b}, bad_any_copy);
+}
@@ -0,0 +1,183 @@
+// built in C++20, in its own executable
+#include "../any_coroutine.hpp"
+#include "../any_compare.hpp"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+namespace {
+
+// coroutine started on call, and destroyed when it returns
+struct Detached
+{
+	struct promise_type
+	{
+		Detached get_return_object() { return {}; }
+		std::suspend_never initial_suspend() noexcept { return {}; }
+		std::suspend_never final_suspend() noexcept { return {}; }
+		void return_void() {}
+		void unhandled_exception() { std::terminate(); }
+	};
+};
+
+using Channel = static_any_channel<32>;
+using Future = static_any_future<32>;
+
+Detached receive(Channel& channel, static_any<32>& received, int& resumed)
+{
+	received = co_await channel;
+	++resumed;
+}
+
+Future make_int(int i)
+{
+	co_return i;
+}
+
+Future make_string(const char* s)
+{
+	co_return std::string(s);
+}
+
+Future sum(int a, int b)
+{
+	const int i = any_cast<int>(co_await make_int(a));
+	const int j = (co_await make_int(b)).get<int>();
+	co_return i + j;
+}
+
+Future fail()
+{
+	throw std::runtime_error("fail");
+	co_return 0;
+}
+
+}
+
+TEST(any_coroutine, channel_resumes_the_consumer)
+{
+	Channel channel;
+	static_any<32> received;
+	int resumed = 0;
+
+	receive(channel, received, resumed);
+	ASSERT_TRUE(channel.waiting());
+	ASSERT_EQ(0, resumed);
+
+	channel.emplace<std::string>(3, 'x');
+	ASSERT_EQ(1, resumed);
+	ASSERT_EQ("xxx", received.get<std::string>());
+	ASSERT_FALSE(channel.ready());
+	ASSERT_FALSE(channel.waiting());
+
+	// ready before the consumer: no suspension
+	channel.send(2.5);
+	ASSERT_TRUE(channel.ready());
+	receive(channel, received, resumed);
+	ASSERT_EQ(2, resumed);
+	ASSERT_EQ(2.5, received.get<double>());
+	ASSERT_FALSE(channel.ready());
+}
+
+TEST(any_coroutine, channel_receive)
+{
+	Channel channel;
+	int received = 0;
+	bool failed = false;
+
+	auto consumer = [&channel, &received, &failed]() -> Detached
+	{
+		received = co_await channel.receive<int>();
+
+		try
+		{
+			co_await channel.receive<int>();
+		}
+		catch (const bad_any_cast&)
+		{
+			failed = true;
+		}
+
+		try
+		{
+			co_await channel;
+		}
+		catch (const std::runtime_error& e)
+		{
+			EXPECT_STREQ("producer", e.what());
+			received = -1;
+		}
+	};
+	consumer();
+
+	channel.send(7);
+	ASSERT_EQ(7, received);
+
+	channel.send(std::string("not an int"));
+	ASSERT_TRUE(failed);
+	ASSERT_FALSE(channel.ready());
+
+	channel.set_exception(std::make_exception_ptr(std::runtime_error("producer")));
+	ASSERT_EQ(-1, received);
+	ASSERT_FALSE(channel.waiting());
+}
+
+TEST(any_coroutine, channel_across_threads)
+{
+	Channel channel;
+	static_any<32> received;
+	int resumed = 0;
+
+	for (int i = 0; i < 100; ++i)
+	{
+		std::thread producer([&channel, i]() { channel.send(i); });
+		receive(channel, received, resumed);
+		producer.join();
+
+		ASSERT_EQ(i + 1, resumed);
+		ASSERT_EQ(i, received.get<int>());
+	}
+}
+
+TEST(any_coroutine, future)
+{
+	static_any<32> result;
+	std::string text;
+
+	auto consumer = [&result, &text]() -> Detached
+	{
+		result = co_await sum(1, 2);
+		text = any_cast<std::string>(co_await make_string("foo"));
+	};
+
+	consumer();
+	ASSERT_EQ(3, result.get<int>());
+	ASSERT_EQ("foo", text);
+
+	Future never_awaited = make_int(1);
+	ASSERT_FALSE(never_awaited.ready());
+}
+
+TEST(any_coroutine, future_exception)
+{
+	bool caught = false;
+
+	auto consumer = [&caught]() -> Detached
+	{
+		try
+		{
+			co_await fail();
+		}
+		catch (const std::runtime_error&)
+		{
+			caught = true;
+		}
+	};
+
+	consumer();
+	ASSERT_TRUE(caught);
+}
@@ -0,0 +1,88 @@
+#include "../any_function.hpp"
+#include "../any_compare.hpp"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+
+namespace {
+
+int add(int a, int b) { return a + b; }
+
+struct Accumulator
+{
+	int operator()(int i) { return sum += i; }
+	int sum = 0;
+};
+
+}
+
+TEST(static_function, call)
+{
+	static_function<int(int, int), 16> f = add;
+	ASSERT_TRUE(f);
+	ASSERT_EQ(3, f(1, 2));
+
+	f = [](int a, int b) { return a * b; };
+	ASSERT_EQ(6, f(2, 3));
+
+	const int offset = 10;
+	f = [offset](int a, int b) { return offset + a + b; };
+	ASSERT_EQ(13, f(1, 2));
+}
+
+TEST(static_function, empty)
+{
+	static_function<void(), 16> f;
+	ASSERT_FALSE(f);
+	ASSERT_TRUE(f == nullptr);
+	ASSERT_THROW(f(), std::bad_function_call);
+
+	int calls = 0;
+	f = [&calls]() { ++calls; };
+	f();
+	ASSERT_EQ(1, calls);
+	ASSERT_TRUE(f != nullptr);
+
+	f = nullptr;
+	ASSERT_TRUE(f.empty());
+	ASSERT_THROW(f(), std::bad_function_call);
+}
+
+TEST(static_function, state)
+{
+	static_function<int(int), 16> f = Accumulator();
+	f(1);
+	f(2);
+	ASSERT_EQ(3, f.target<Accumulator>()->sum);
+	ASSERT_EQ(nullptr, f.target<int(*)(int)>());
+	ASSERT_EQ(typeid(Accumulator), f.target_type());
+
+	static_function<int(int), 16> g = f;
+	ASSERT_EQ(6, g(3));
+	ASSERT_EQ(4, f(1));
+}
+
+TEST(static_function, conversions)
+{
+	static_function<long(std::string), 16> f = [](const std::string& s) { return static_cast<int>(s.size()); };
+	ASSERT_EQ(3, f("foo"));
+
+	// the result is discarded
+	static_function<void(int), 16> g = [](int i) { return add(i, i); };
+	g(1);
+}
+
+TEST(static_function, move_only)
+{
+	std::unique_ptr<int> p(new int(42));
+	static_function<int(), 16> f = [p = std::move(p)]() { return *p; };
+	ASSERT_EQ(42, f());
+
+	static_function<int(), 16> g = std::move(f);
+	ASSERT_EQ(42, g());
+
+	using Function = static_function<int(), 16>;
+	ASSERT_THROW(Function{g}, bad_any_copy);
+}
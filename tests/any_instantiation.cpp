@@ -0,0 +1,6 @@
+#include "../any.hpp"
+
+// the tests are built with STATIC_ANY_EXTERN_COMMON_SIZES: the members of these sizes are only compiled here
+STATIC_ANY_INSTANTIATE_COMMON_SIZES();
+
+STATIC_ANY_INSTANTIATE(24, 8);
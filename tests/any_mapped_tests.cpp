@@ -0,0 +1,161 @@
+#include "../any_mapped.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+// the values are identified by the hash of the name of their type: their types can not be in an anonymous namespace
+namespace mapped_tests {
+
+struct Position
+{
+	int instrument;
+	double quantity;
+};
+
+}
+
+namespace {
+
+using mapped_tests::Position;
+using Array = mapped_any_array<16>;
+
+// removed when the test ends
+struct TemporaryFile
+{
+	explicit TemporaryFile(const char* p) : path(p) {}
+	~TemporaryFile() { std::remove(path); }
+
+	const char* path;
+};
+
+std::vector<Array::value_type> make_values(int count)
+{
+	std::vector<Array::value_type> values;
+	for (int i = 0; i < count; ++i)
+	{
+		if (i % 3 == 0)
+			values.emplace_back(Position{i, i * 0.5});
+		else
+			values.emplace_back(i);
+	}
+	return values;
+}
+
+void write_bytes(const char* path, const void* data, std::size_t size)
+{
+	std::FILE* file = std::fopen(path, "wb");
+	ASSERT_NE(nullptr, file);
+	ASSERT_EQ(size, std::fwrite(data, 1, size, file));
+	std::fclose(file);
+}
+
+}
+
+TEST(any_mapped, save_load)
+{
+	const TemporaryFile file("any_mapped_save_load.bin");
+	const std::vector<Array::value_type> values = make_values(100);
+	Array::save(file.path, values.data(), values.size());
+
+	Array mapped(file.path);
+	ASSERT_EQ(100u, mapped.size());
+	ASSERT_FALSE(mapped.writable());
+
+	ASSERT_EQ(2u, mapped.type_count());
+	ASSERT_TRUE(mapped.contains_type<int>());
+	ASSERT_TRUE(mapped.contains_type<Position>());
+	ASSERT_FALSE(mapped.contains_type<double>());
+
+	ASSERT_TRUE(mapped.has<Position>(99));
+	ASSERT_EQ(99, mapped.get<Position>(99).instrument);
+	ASSERT_EQ(49.5, mapped.get<Position>(99).quantity);
+	ASSERT_EQ(98, mapped.get<int>(98));
+	ASSERT_EQ(nullptr, mapped.try_get<Position>(98));
+
+	// read in place, and only as const
+	ASSERT_EQ(0u, reinterpret_cast<std::uintptr_t>(mapped.data()) % alignof(Array::value_type));
+	static_assert(std::is_same<decltype(mapped[0]), const Array::value_type&>::value, "read-only values");
+	static_assert(std::is_same<decltype(mapped.get<int>(0)), const int&>::value, "read-only values");
+
+	int ints = 0;
+	for (const Array::value_type& value : mapped)
+		ints += value.has<int>() ? 1 : 0;
+	ASSERT_EQ(66, ints);
+
+	Array moved = std::move(mapped);
+	ASSERT_EQ(100u, moved.size());
+	ASSERT_TRUE(mapped.empty());
+}
+
+TEST(any_mapped, empty)
+{
+	const TemporaryFile file("any_mapped_empty.bin");
+	Array::save(file.path, nullptr, 0);
+
+	const Array mapped(file.path);
+	ASSERT_TRUE(mapped.empty());
+	ASSERT_EQ(0u, mapped.type_count());
+	ASSERT_EQ(mapped.begin(), mapped.end());
+}
+
+TEST(any_mapped, copy_on_write)
+{
+	const TemporaryFile file("any_mapped_copy_on_write.bin");
+	const std::vector<Array::value_type> values = make_values(10);
+	Array::save(file.path, values.data(), values.size());
+
+	{
+		Array mapped(file.path, static_any_map_mode::copy_on_write);
+		ASSERT_TRUE(mapped.writable());
+		Array::value_type* written = mapped.writable_data();
+		written[1].get<int>() = 42;
+		written[2] = Position{7, 1.0};
+		ASSERT_EQ(42, mapped.get<int>(1));
+		ASSERT_EQ(7, mapped.get<Position>(2).instrument);
+	}
+
+	// the file is unchanged
+	Array mapped(file.path);
+	ASSERT_EQ(1, mapped.get<int>(1));
+	ASSERT_EQ(2, mapped.get<int>(2));
+
+	// the pages of a read-only mapping are protected
+	ASSERT_THROW(mapped.writable_data(), std::logic_error);
+}
+
+TEST(any_mapped, invalid_files)
+{
+	ASSERT_THROW(Array("any_mapped_missing.bin"), std::system_error);
+
+	const TemporaryFile file("any_mapped_invalid.bin");
+	const std::vector<Array::value_type> values = make_values(10);
+	Array::save(file.path, values.data(), values.size());
+
+	// another capacity
+	ASSERT_THROW(mapped_any_array<8>(file.path), std::runtime_error);
+	ASSERT_THROW((mapped_any_array<16, 16>(file.path)), std::runtime_error);
+
+	std::vector<char> bytes(sizeof(static_any_mapped_header) + 2 * sizeof(static_any_type_id_t) + 10 * sizeof(Array::value_type));
+	std::FILE* f = std::fopen(file.path, "rb");
+	ASSERT_NE(nullptr, f);
+	ASSERT_EQ(bytes.size(), std::fread(bytes.data(), 1, bytes.size(), f));
+	std::fclose(f);
+
+	write_bytes(file.path, bytes.data(), bytes.size() - 1);
+	ASSERT_THROW(Array(file.path), std::runtime_error);
+
+	write_bytes(file.path, bytes.data(), sizeof(static_any_mapped_header) - 1);
+	ASSERT_THROW(Array(file.path), std::runtime_error);
+
+	write_bytes(file.path, bytes.data(), 0);
+	ASSERT_THROW(Array(file.path), std::runtime_error);
+
+	bytes[0] = 'x';
+	write_bytes(file.path, bytes.data(), bytes.size());
+	ASSERT_THROW(Array(file.path), std::runtime_error);
+}
@@ -0,0 +1,115 @@
+#include "../any_parallel.hpp"
+#include "../any_compare.hpp"
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Collector
+{
+	void operator()(int* values, std::size_t count) { ints.assign(values, values + count); }
+	void operator()(double* values, std::size_t count) { doubles.assign(values, values + count); }
+	void operator()(std::string* values, std::size_t count) { strings.assign(values, values + count); }
+
+	std::vector<int> ints;
+	std::vector<double> doubles;
+	std::vector<std::string> strings;
+};
+
+struct Tracked
+{
+	explicit Tracked(int i) : value(i) { ++alive; }
+	Tracked(const Tracked& t) : value(t.value) { ++alive; }
+	Tracked(Tracked&& t) : value(t.value) { if (value == throw_on_move) throw std::runtime_error("move"); ++alive; }
+	~Tracked() { --alive; }
+
+	int value;
+
+	static int throw_on_move;
+	static std::atomic<int> alive;
+};
+
+int Tracked::throw_on_move = -1;
+std::atomic<int> Tracked::alive{0};
+
+}
+
+TEST(any_parallel, process_by_type)
+{
+	std::vector<static_any<32>> events;
+	for (int i = 0; i < 10000; ++i)
+	{
+		switch (i % 4)
+		{
+		case 0: events.emplace_back(i); break;
+		case 1: events.emplace_back(static_cast<double>(i)); break;
+		case 2: events.emplace_back(std::to_string(i)); break;
+		default: events.emplace_back(static_cast<char>('a' + i % 26)); break;
+		}
+	}
+
+	for (std::size_t threads : { 1u, 4u })
+	{
+		std::vector<static_any<32>> copy = events;
+
+		Collector collector;
+		parallel_process_by_type<int, double, std::string>(copy.data(), copy.data() + copy.size(), collector, threads, 97);
+
+		ASSERT_EQ(2500u, collector.ints.size());
+		ASSERT_EQ(2500u, collector.doubles.size());
+		ASSERT_EQ(2500u, collector.strings.size());
+
+		// stable: in the order of the range
+		for (std::size_t i = 0; i < 2500; ++i)
+		{
+			ASSERT_EQ(static_cast<int>(4 * i), collector.ints[i]);
+			ASSERT_EQ(static_cast<double>(4 * i + 1), collector.doubles[i]);
+			ASSERT_EQ(std::to_string(4 * i + 2), collector.strings[i]);
+		}
+
+		// the types not listed are left untouched
+		ASSERT_EQ('d', copy[3].get<char>());
+		ASSERT_TRUE(copy[2].has<std::string>());
+	}
+}
+
+TEST(any_parallel, missing_types)
+{
+	std::vector<static_any<32>> events = { 1, 2, static_any<32>(), 3 };
+
+	Collector collector;
+	parallel_process_by_type<int, double, std::string>(events.data(), events.data() + events.size(), collector, 2, 1);
+	ASSERT_EQ((std::vector<int>{1, 2, 3}), collector.ints);
+	ASSERT_TRUE(collector.doubles.empty());
+
+	parallel_process_by_type<int>(events.data(), events.data(), collector);
+}
+
+TEST(any_parallel, exceptions)
+{
+	std::vector<static_any<16>> events;
+	for (int i = 0; i < 1000; ++i)
+		events.emplace_back(Tracked(i));
+
+	Tracked::throw_on_move = 500;
+	std::size_t handled = 0;
+	ASSERT_THROW((parallel_process_by_type<Tracked>(events.data(), events.data() + events.size(),
+		[&handled](Tracked*, std::size_t count) { handled = count; }, 4, 64)), std::runtime_error);
+	Tracked::throw_on_move = -1;
+
+	ASSERT_EQ(0u, handled);
+	ASSERT_EQ(1000, Tracked::alive);
+
+	ASSERT_THROW((parallel_process_by_type<Tracked>(events.data(), events.data() + events.size(),
+		[](Tracked*, std::size_t) { throw std::logic_error("handler"); }, 4, 64)), std::logic_error);
+	ASSERT_EQ(1000, Tracked::alive);
+
+	parallel_process_by_type<Tracked>(events.data(), events.data() + events.size(),
+		[&handled](Tracked* values, std::size_t count) { handled = count; ASSERT_EQ(999, values[999].value); }, 4, 64);
+	ASSERT_EQ(1000u, handled);
+	ASSERT_EQ(1000, Tracked::alive);
+}
@@ -0,0 +1,131 @@
+#include "../any_poly.hpp"
+#include "../any_compare.hpp"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <type_traits>
+
+namespace {
+
+struct Shape
+{
+	virtual double area() const = 0;
+	virtual void scale(double factor) = 0;
+};
+
+struct Square : Shape
+{
+	explicit Square(double s) : side(s) {}
+
+	double area() const override { return side * side; }
+	void scale(double factor) override { side *= factor; }
+
+	double side;
+};
+
+struct Named
+{
+	std::string name = "circle";
+};
+
+// Shape is not the first base: the pointer to the interface is not the address of the value
+struct Circle : Named, Shape
+{
+	explicit Circle(double r) : radius(r) {}
+
+	double area() const override { return 3.0 * radius * radius; }
+	void scale(double factor) override { radius *= factor; }
+
+	double radius;
+};
+
+struct Counted : Square
+{
+	Counted() : Square(1.0) { ++instances; }
+	Counted(const Counted& c) : Square(c) { ++instances; }
+	~Counted() { --instances; }
+
+	static int instances;
+};
+
+int Counted::instances = 0;
+
+// Shape is not reachable through a Shape pointer
+struct Hidden : private Shape
+{
+	double area() const override { return 0.0; }
+	void scale(double) override {}
+};
+
+// two Shape bases
+struct Twice : Square, Circle
+{
+	Twice() : Square(1.0), Circle(1.0) {}
+};
+
+using AnyShape = static_poly<Shape, 64>;
+
+static_assert(!std::is_constructible<AnyShape, Hidden>::value, "private base");
+static_assert(!std::is_constructible<AnyShape, Twice>::value, "ambiguous base");
+static_assert(!std::is_assignable<AnyShape&, Hidden>::value, "private base");
+static_assert(std::is_constructible<AnyShape, Circle>::value, "public base");
+
+}
+
+TEST(static_poly, virtual_call)
+{
+	AnyShape s = Square(2.0);
+	ASSERT_EQ(4.0, s->area());
+
+	s->scale(2.0);
+	ASSERT_EQ(16.0, (*s).area());
+
+	s = Circle(1.0);
+	ASSERT_EQ(3.0, s->area());
+	ASSERT_TRUE(s.has<Circle>());
+
+	const AnyShape& cs = s;
+	ASSERT_EQ(3.0, cs.get()->area());
+}
+
+TEST(static_poly, copy)
+{
+	AnyShape a = Circle(1.0);
+	AnyShape b = a;
+
+	b->scale(2.0);
+	ASSERT_EQ(3.0, a->area());
+	ASSERT_EQ(12.0, b->area());
+
+	a = b;
+	ASSERT_EQ(12.0, a->area());
+}
+
+TEST(static_poly, empty)
+{
+	AnyShape s;
+	ASSERT_FALSE(s);
+	ASSERT_EQ(nullptr, s.get());
+
+	s.emplace<Square>(3.0);
+	ASSERT_EQ(9.0, s->area());
+
+	s.reset();
+	ASSERT_TRUE(s.empty());
+}
+
+TEST(static_poly, destruction)
+{
+	{
+		AnyShape s = Counted();
+		ASSERT_EQ(1, Counted::instances);
+
+		s = Square(1.0);
+		ASSERT_EQ(0, Counted::instances);
+
+		s.emplace<Counted>();
+		ASSERT_EQ(1, Counted::instances);
+	}
+	ASSERT_EQ(0, Counted::instances);
+}
@@ -0,0 +1,116 @@
+#include "../any_pool.hpp"
+#include "../any_compare.hpp"
+
+#include <gtest/gtest.h>
+
+#include <set>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Counted
+{
+	Counted(int i) : value(i) { ++constructions; if (i == 42) throw std::runtime_error("construct"); }
+	~Counted() { ++destructions; }
+
+	static void reset_counters() { constructions = destructions = 0; }
+
+	int value;
+
+	static int constructions;
+	static int destructions;
+};
+
+int Counted::constructions = 0;
+int Counted::destructions = 0;
+
+}
+
+TEST(any_pool, acquire_release)
+{
+	static_any_pool<32> pool(4);
+	ASSERT_EQ(0u, pool.capacity());
+
+	static_any<32>* a = pool.acquire();
+	ASSERT_TRUE(a->empty());
+	*a = std::string("foo");
+
+	static_any<32>* b = pool.create<int>(42);
+	ASSERT_EQ(42, b->get<int>());
+	ASSERT_EQ("foo", a->get<std::string>());
+
+	ASSERT_EQ(2u, pool.live_count());
+	ASSERT_EQ(4u, pool.capacity());
+
+	// the slot is recycled
+	pool.release(a);
+	ASSERT_EQ(1u, pool.live_count());
+	ASSERT_EQ(a, pool.acquire());
+	ASSERT_TRUE(a->empty());
+	ASSERT_EQ(2u, pool.high_water_mark());
+}
+
+TEST(any_pool, pages)
+{
+	static_any_pool<16> pool(4);
+
+	std::set<static_any<16>*> values;
+	for (int i = 0; i < 10; ++i)
+		values.insert(pool.create<int>(i));
+
+	ASSERT_EQ(10u, values.size());
+	ASSERT_EQ(12u, pool.capacity());
+	ASSERT_EQ(10u, pool.high_water_mark());
+
+	for (static_any<16>* value : values)
+		pool.release(value);
+
+	ASSERT_EQ(0u, pool.live_count());
+	ASSERT_EQ(10u, pool.high_water_mark());
+
+	// no new page
+	for (int i = 0; i < 10; ++i)
+		ASSERT_EQ(1u, values.count(pool.acquire()));
+	ASSERT_EQ(12u, pool.capacity());
+}
+
+TEST(any_pool, clear)
+{
+	Counted::reset_counters();
+	{
+		static_any_pool<16> pool(4);
+		for (int i = 0; i < 6; ++i)
+		{
+			pool.create<Counted>(i);
+			pool.create<int>(i);
+		}
+
+		pool.release(pool.create<Counted>(7));
+		ASSERT_EQ(1, Counted::destructions);
+
+		pool.clear();
+		ASSERT_EQ(7, Counted::destructions);
+		ASSERT_EQ(0u, pool.live_count());
+		ASSERT_EQ(13u, pool.high_water_mark());
+
+		// the pages are reused
+		const std::size_t capacity = pool.capacity();
+		for (int i = 0; i < 10; ++i)
+			pool.create<Counted>(i);
+		ASSERT_EQ(capacity, pool.capacity());
+	}
+	ASSERT_EQ(Counted::constructions, Counted::destructions);
+}
+
+TEST(any_pool, create_throws)
+{
+	static_any_pool<16> pool(4);
+
+	ASSERT_THROW(pool.create<Counted>(42), std::runtime_error);
+	ASSERT_EQ(0u, pool.live_count());
+
+	static_any<16>* a = pool.create<Counted>(1);
+	ASSERT_EQ(1, a->get<Counted>().value);
+	ASSERT_EQ(1u, pool.live_count());
+}
@@ -0,0 +1,238 @@
+#include "../any_queue.hpp"
+#include "../any_compare.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct ThrowingConstructor
+{
+	ThrowingConstructor(int i) { if (i == 42) throw std::runtime_error("construct"); }
+};
+
+struct Produced
+{
+	int producer;
+	int index;
+};
+
+}
+
+TEST(any_queue, spsc_push_pop)
+{
+	spsc_any_queue<32> q(3);
+	ASSERT_EQ(4u, q.capacity());
+	ASSERT_TRUE(q.empty());
+
+	ASSERT_TRUE(q.try_push(1));
+	ASSERT_TRUE(q.try_push(std::string("foo")));
+	ASSERT_TRUE(q.try_emplace<std::string>(3u, 'a'));
+	ASSERT_TRUE(q.try_push(static_any<8>(2.0)));
+	ASSERT_FALSE(q.try_push(5));
+	ASSERT_FALSE(q.empty());
+
+	static_any<32> value;
+	ASSERT_TRUE(q.try_pop(value));
+	ASSERT_EQ(1, value.get<int>());
+	ASSERT_TRUE(q.try_pop(value));
+	ASSERT_EQ("foo", value.get<std::string>());
+	ASSERT_TRUE(q.try_pop(value));
+	ASSERT_EQ("aaa", value.get<std::string>());
+	ASSERT_TRUE(q.try_pop(value));
+	ASSERT_EQ(2.0, value.get<double>());
+
+	ASSERT_FALSE(q.try_pop(value));
+	ASSERT_TRUE(q.empty());
+}
+
+TEST(any_queue, spsc_consume)
+{
+	spsc_any_queue<32> q(2);
+
+	// wraps around several times
+	for (int i = 0; i < 10; ++i)
+	{
+		ASSERT_TRUE(q.try_push(std::to_string(i)));
+
+		std::string consumed;
+		ASSERT_TRUE(q.try_consume([&consumed](static_any<32>& value) { consumed = value.get<std::string>(); }));
+		ASSERT_EQ(std::to_string(i), consumed);
+	}
+
+	// the value is released even if f throws
+	ASSERT_TRUE(q.try_push(1));
+	ASSERT_THROW(q.try_consume([](static_any<32>& value) { value.get<double>(); }), bad_any_cast);
+	ASSERT_TRUE(q.empty());
+}
+
+TEST(any_queue, over_aligned_slots)
+{
+	using Aligned = static_any<128, 128>;
+
+	spsc_any_queue<128, 128> spsc(4);
+	mpsc_any_queue<128, 128> mpsc(4);
+
+	for (int i = 0; i < 4; ++i)
+	{
+		ASSERT_TRUE(spsc.try_push(i));
+		ASSERT_TRUE(mpsc.try_push(i));
+	}
+
+	const auto check = [](Aligned& value) { ASSERT_EQ(0u, reinterpret_cast<std::uintptr_t>(&value) % 128); };
+	for (int i = 0; i < 4; ++i)
+	{
+		ASSERT_TRUE(spsc.try_consume(check));
+		ASSERT_TRUE(mpsc.try_consume(check));
+	}
+}
+
+TEST(any_queue, spsc_throwing_constructor)
+{
+	spsc_any_queue<16> q(2);
+
+	ASSERT_THROW(q.try_emplace<ThrowingConstructor>(42), std::runtime_error);
+	ASSERT_TRUE(q.empty());
+
+	ASSERT_TRUE(q.try_emplace<ThrowingConstructor>(1));
+	ASSERT_FALSE(q.empty());
+}
+
+TEST(any_queue, spsc_empty_value)
+{
+	spsc_any_queue<16> q(2);
+
+	ASSERT_TRUE(q.try_push(static_any<16>()));
+	ASSERT_TRUE(q.try_push(1));
+
+	// an empty value is delivered, as by mpsc_any_queue
+	static_any<16> value = 2;
+	ASSERT_TRUE(q.try_pop(value));
+	ASSERT_TRUE(value.empty());
+	ASSERT_TRUE(q.try_pop(value));
+	ASSERT_EQ(1, value.get<int>());
+	ASSERT_FALSE(q.try_pop(value));
+}
+
+TEST(any_queue, spsc_threads)
+{
+	const int count = 50000;
+	spsc_any_queue<32> q(64);
+
+	std::thread producer([&q]()
+	{
+		for (int i = 0; i < count; ++i)
+		{
+			if (i % 2 == 0)
+				while (!q.try_push(i)) std::this_thread::yield();
+			else
+				while (!q.try_push(std::to_string(i))) std::this_thread::yield();
+		}
+	});
+
+	int expected = 0;
+	while (expected < count)
+	{
+		const bool consumed = q.try_consume([&expected](static_any<32>& value)
+		{
+			if (expected % 2 == 0)
+				ASSERT_EQ(expected, value.get<int>());
+			else
+				ASSERT_EQ(std::to_string(expected), value.get<std::string>());
+			++expected;
+		});
+
+		if (!consumed)
+			std::this_thread::yield();
+	}
+
+	producer.join();
+	ASSERT_TRUE(q.empty());
+}
+
+TEST(any_queue, mpsc_push_pop)
+{
+	mpsc_any_queue<32> q(2);
+	ASSERT_EQ(2u, q.capacity());
+
+	ASSERT_TRUE(q.try_push(1));
+	ASSERT_TRUE(q.try_emplace<std::string>("foo"));
+	ASSERT_FALSE(q.try_push(2));
+
+	static_any<32> value;
+	ASSERT_TRUE(q.try_pop(value));
+	ASSERT_EQ(1, value.get<int>());
+	ASSERT_TRUE(q.try_push(2.0));
+
+	std::string consumed;
+	ASSERT_TRUE(q.try_consume([&consumed](static_any<32>& v) { consumed = v.get<std::string>(); }));
+	ASSERT_EQ("foo", consumed);
+	ASSERT_TRUE(q.try_pop(value));
+	ASSERT_EQ(2.0, value.get<double>());
+	ASSERT_FALSE(q.try_pop(value));
+}
+
+TEST(any_queue, mpsc_throwing_constructor)
+{
+	mpsc_any_queue<16> q(4);
+
+	ASSERT_TRUE(q.try_push(1));
+	ASSERT_THROW(q.try_emplace<ThrowingConstructor>(42), std::runtime_error);
+	ASSERT_TRUE(q.try_push(static_any<16>()));
+	ASSERT_TRUE(q.try_push(2));
+
+	// the slot of the value which failed to construct is skipped, the empty value is delivered
+	static_any<16> value;
+	ASSERT_TRUE(q.try_pop(value));
+	ASSERT_EQ(1, value.get<int>());
+	ASSERT_TRUE(q.try_pop(value));
+	ASSERT_TRUE(value.empty());
+	ASSERT_TRUE(q.try_pop(value));
+	ASSERT_EQ(2, value.get<int>());
+	ASSERT_FALSE(q.try_pop(value));
+}
+
+TEST(any_queue, mpsc_threads)
+{
+	const int producers = 4;
+	const int count = 10000;
+	mpsc_any_queue<16> q(64);
+
+	std::vector<std::thread> threads;
+	for (int p = 0; p < producers; ++p)
+	{
+		threads.emplace_back([&q, p]()
+		{
+			for (int i = 0; i < count; ++i)
+				while (!q.try_push(Produced{p, i})) std::this_thread::yield();
+		});
+	}
+
+	// the values of each producer are received in order
+	std::vector<int> next(producers, 0);
+	int received = 0;
+	static_any<16> value;
+	while (received < producers * count)
+	{
+		if (!q.try_pop(value))
+		{
+			std::this_thread::yield();
+			continue;
+		}
+
+		const Produced& produced = value.get<Produced>();
+		const std::size_t producer = static_cast<std::size_t>(produced.producer);
+		ASSERT_EQ(next[producer], produced.index);
+		++next[producer];
+		++received;
+	}
+
+	for (std::thread& t : threads)
+		t.join();
+
+	ASSERT_FALSE(q.try_pop(value));
+}
@@ -0,0 +1,205 @@
+#include "../any_record.hpp"
+#include "../any_wire.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include <vector>
+
+// the fields are identified by the hash of the name of their type: their types can not be in an anonymous namespace
+namespace record_tests {
+
+struct Price
+{
+	std::int64_t mantissa;
+	std::int8_t exponent;
+};
+
+}
+
+namespace {
+
+using record_tests::Price;
+using Row = static_record<64, 8>;
+
+Row make_row(int id, double price, char side)
+{
+	Row row;
+	row.push_back(id);
+	row.push_back(price);
+	row.push_back(side);
+	return row;
+}
+
+}
+
+static_assert(std::is_trivially_copyable<Row>::value, "static_record has to be copied with a memcpy");
+
+TEST(any_record, push_back_get)
+{
+	Row row;
+	ASSERT_TRUE(row.empty());
+
+	ASSERT_EQ(0u, row.push_back('a'));
+	ASSERT_EQ(1u, row.push_back(2.5));
+	ASSERT_EQ(2u, row.push_back(Price{12345, -2}));
+	ASSERT_EQ(3u, row.push_back(7));
+
+	ASSERT_EQ(4u, row.size());
+	ASSERT_EQ('a', row.get<char>(0));
+	ASSERT_EQ(2.5, row.get<double>(1));
+	ASSERT_EQ(12345, row.get<Price>(2).mantissa);
+	ASSERT_EQ(7, row.get<int>(3));
+
+	// each field is aligned after the previous one
+	ASSERT_EQ(0u, row.offset(0));
+	ASSERT_EQ(8u, row.offset(1));
+	ASSERT_EQ(16u, row.offset(2));
+	ASSERT_EQ(32u, row.offset(3));
+	ASSERT_EQ(36u, row.bytes());
+
+	ASSERT_TRUE(row.has<double>(1));
+	ASSERT_FALSE(row.has<float>(1));
+	ASSERT_EQ(static_any_type_id<Price>::value, row.type_id(2));
+	ASSERT_EQ(nullptr, row.try_get<long>(3));
+
+	row.get<int>(3) = 8;
+	ASSERT_EQ(8, *row.try_get<int>(3));
+
+	row.clear();
+	ASSERT_TRUE(row.empty());
+	ASSERT_EQ(0u, row.bytes());
+}
+
+TEST(any_record, full)
+{
+	static_record<16, 2> row;
+	row.push_back(1);
+	row.push_back(2.0);
+	ASSERT_THROW(row.push_back(3), std::length_error);
+
+	static_record<20, 4> small;
+	small.push_back('a');
+	small.push_back(2.0);
+	ASSERT_THROW(small.push_back(3.0), std::length_error);
+	ASSERT_EQ(2u, small.size());
+
+	small.push_back(3);
+	ASSERT_EQ(3u, small.size());
+}
+
+TEST(any_record, types)
+{
+	// a narrow index per field, into a table of the types of the record
+	static_assert(sizeof(Row::type_index_type) == 1, "one byte per field");
+	static_assert(sizeof(Row) < 64 + 8 * (sizeof(static_any_type_id_t) + sizeof(Row::offset_type)), "a type id per field");
+
+	static_record<64, 4, 8, 2> row;
+	row.push_back(1);
+	row.push_back(2.0);
+	row.push_back(3);
+	ASSERT_THROW(row.push_back('a'), std::length_error);
+	ASSERT_EQ(3u, row.size());
+
+	ASSERT_TRUE(row.has<const int>(2));
+	ASSERT_EQ(3, row.get<const int>(2));
+	ASSERT_EQ(static_any_type_id<int>::value, row.type_id(2));
+	ASSERT_EQ(static_any_type_id<double>::value, row.type_id(1));
+
+	int sum = 0;
+	row.for_each<const int>([&sum](const int& i) { sum += i; });
+	ASSERT_EQ(4, sum);
+	row.for_each<char>([](char) { FAIL(); });
+
+	row.clear();
+	row.push_back('a');
+	row.push_back(std::int16_t{2});
+	ASSERT_EQ('a', row.get<char>(0));
+}
+
+TEST(any_record, zeroed_bytes)
+{
+	alignas(Row) unsigned char bytes[sizeof(Row)];
+	const auto all_zero = [&bytes]() { return std::all_of(std::begin(bytes), std::end(bytes), [](unsigned char b) { return b == 0; }); };
+
+	std::memset(bytes, 0xaa, sizeof(bytes));
+	Row* row = new(bytes) Row();
+	ASSERT_TRUE(all_zero());
+
+	row->push_back('a');
+	row->push_back(2.5);
+	row->push_back(Price{12345, -2});
+	row->clear();
+	ASSERT_TRUE(all_zero());
+
+	// equal records hold the same bytes
+	const Row a = make_row(1, 2.5, 'b');
+	const Row b = make_row(1, 2.5, 'b');
+	ASSERT_TRUE(a == b);
+	ASSERT_EQ(0, std::memcmp(&a, &b, sizeof(Row)));
+}
+
+TEST(any_record, copy_compare)
+{
+	const Row row = make_row(1, 2.5, 'b');
+
+	Row copy;
+	std::memcpy(static_cast<void*>(&copy), &row, sizeof(row));
+	ASSERT_TRUE(copy == row);
+	ASSERT_EQ(2.5, copy.get<double>(1));
+
+	copy.get<char>(2) = 's';
+	ASSERT_TRUE(copy != row);
+	ASSERT_TRUE(make_row(1, 2.5, 'b') == row);
+	ASSERT_FALSE(make_row(1, 2.5, 'b') == make_row(2, 2.5, 'b'));
+
+	Row other;
+	other.push_back(1);
+	ASSERT_FALSE(other == row);
+}
+
+TEST(any_record, for_each)
+{
+	Row row;
+	row.push_back(1);
+	row.push_back(2.0);
+	row.push_back(3);
+
+	int sum = 0;
+	row.for_each<int>([&sum](int& i) { sum += i; i = 0; });
+	ASSERT_EQ(4, sum);
+
+	const Row& crow = row;
+	crow.for_each<int>([](const int& i) { EXPECT_EQ(0, i); });
+}
+
+TEST(any_record, column)
+{
+	std::vector<Row> rows;
+	for (int i = 0; i < 10; ++i)
+		rows.push_back(make_row(i, i * 0.5, 'b'));
+	rows.push_back(Row());
+
+	double total = 0.0;
+	ASSERT_EQ(10u, for_each_in_column<double>(rows.data(), rows.data() + rows.size(), 1, [&total](double d) { total += d; }));
+	ASSERT_EQ(22.5, total);
+
+	ASSERT_EQ(0u, for_each_in_column<int>(rows.data(), rows.data() + rows.size(), 1, [](int) {}));
+}
+
+TEST(any_record, wire)
+{
+	const std::vector<Row> rows = { make_row(1, 1.5, 'b'), make_row(2, 2.5, 's') };
+
+	std::vector<char> buffer(serialized_size<Row>(rows.size()));
+	ASSERT_EQ(buffer.size(), serialize(rows.data(), rows.size(), buffer.data(), buffer.size()));
+
+	std::vector<Row> read(2);
+	ASSERT_EQ(2u, deserialize(buffer.data(), buffer.size(), read.data(), read.size()));
+	ASSERT_TRUE(rows == read);
+	ASSERT_EQ('s', read[1].get<char>(2));
+}
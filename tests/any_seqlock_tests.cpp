@@ -0,0 +1,87 @@
+#include "../any_seqlock.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// the fields are all equal, unless a read is torn
+struct Snapshot
+{
+	std::uint64_t values[4];
+};
+
+}
+
+TEST(any_seqlock, store_load)
+{
+	seqlock_any_t<16> cell;
+	ASSERT_EQ(0u, cell.version());
+	ASSERT_EQ(0, cell.load<int>());
+
+	cell.store(42);
+	ASSERT_EQ(42, cell.load<int>());
+	ASSERT_EQ(2u, cell.version());
+
+	cell.store(static_any_t<16>(2.5));
+	ASSERT_EQ(2.5, cell.load().get<double>());
+	ASSERT_EQ(4u, cell.version());
+
+	static_any_t<16> value;
+	ASSERT_TRUE(cell.try_load(value));
+	ASSERT_EQ(2.5, value.get<double>());
+
+	seqlock_any_t<8> initialized(static_any_t<8>(7));
+	ASSERT_EQ(7, initialized.load<int>());
+}
+
+TEST(any_seqlock, odd_sizes)
+{
+	seqlock_any_t<3> bytes;
+	bytes.store('a');
+	ASSERT_EQ('a', bytes.load<char>());
+
+	seqlock_any_t<12> words;
+	words.store(std::uint32_t(4));
+	ASSERT_EQ(4u, words.load<std::uint32_t>());
+}
+
+TEST(any_seqlock, concurrent_readers)
+{
+	const std::uint64_t count = 20000;
+	seqlock_any_t<sizeof(Snapshot)> cell;
+	std::atomic<bool> torn{false};
+
+	std::vector<std::thread> readers;
+	for (int r = 0; r < 3; ++r)
+	{
+		readers.emplace_back([&cell, &torn, count]()
+		{
+			std::uint64_t last = 0;
+			while (last != count)
+			{
+				const Snapshot s = cell.load<Snapshot>();
+				if (s.values[0] != s.values[1] || s.values[0] != s.values[2] || s.values[0] != s.values[3] || s.values[0] < last)
+					torn = true;
+				last = s.values[0];
+				std::this_thread::yield();
+			}
+		});
+	}
+
+	for (std::uint64_t i = 1; i <= count; ++i)
+	{
+		cell.store(Snapshot{{i, i, i, i}});
+		if (i % 64 == 0)
+			std::this_thread::yield();
+	}
+
+	for (std::thread& reader : readers)
+		reader.join();
+
+	ASSERT_FALSE(torn);
+	ASSERT_EQ(2 * count, cell.version());
+}
@@ -0,0 +1,434 @@
+#include "../any_vector.hpp"
+#include "../any_compare.hpp"
+#include "dyn_lib.hpp"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+namespace {
+
+struct Counted
+{
+	Counted(int i) : value(i) { ++constructions; }
+	Counted(const Counted& c) : value(c.value) { ++copies; if (value == throw_on_copy) throw std::runtime_error("copy"); }
+	Counted(Counted&& c) noexcept : value(c.value) { ++moves; }
+	~Counted() { ++destructions; }
+
+	static void reset_counters() { constructions = copies = moves = destructions = 0; }
+
+	int value;
+
+	static int throw_on_copy;
+	static int constructions;
+	static int copies;
+	static int moves;
+	static int destructions;
+};
+
+int Counted::throw_on_copy = -1;
+int Counted::constructions = 0;
+int Counted::copies = 0;
+int Counted::moves = 0;
+int Counted::destructions = 0;
+
+// copied on reallocation, as its move constructor may throw
+struct ThrowingMove
+{
+	ThrowingMove(int i) : value(i) {}
+	ThrowingMove(const ThrowingMove& t) : value(t.value) { if (value == 42) throw std::runtime_error("copy"); }
+	ThrowingMove(ThrowingMove&& t) : value(t.value) { if (value == 42) throw std::runtime_error("move"); }
+
+	int value;
+};
+
+}
+
+TEST(any_vector, push_back_get)
+{
+	static_any_vector<32> v;
+	ASSERT_TRUE(v.empty());
+
+	v.push_back(1);
+	v.push_back(std::string("foo"));
+	v.push_back(2.5);
+
+	ASSERT_EQ(3u, v.size());
+	ASSERT_EQ(1, v.get<int>(0));
+	ASSERT_EQ("foo", v.get<std::string>(1));
+	ASSERT_EQ(2.5, v.get<double>(2));
+
+	ASSERT_TRUE(v.has<int>(0));
+	ASSERT_FALSE(v.has<int>(1));
+	ASSERT_EQ(typeid(std::string), v.type(1));
+	ASSERT_EQ(static_any_type_id<double>::value, v.type_id(2));
+
+	ASSERT_THROW(v.get<double>(0), bad_any_cast);
+	ASSERT_EQ(nullptr, v.try_get<double>(0));
+	ASSERT_EQ(1, *v.try_get<int>(0));
+
+	v.get<int>(0) = 10;
+	ASSERT_EQ(10, v.get<int>(0));
+}
+
+TEST(any_vector, tags)
+{
+	static_any_vector<16> v;
+	v.push_back(1);
+	v.push_back(2.0);
+	v.push_back(3);
+	v.push_back(static_any<8>());
+
+	ASSERT_EQ(v.tag(0), v.tag(2));
+	ASSERT_NE(v.tag(0), v.tag(1));
+	ASSERT_EQ(static_any_vector<16>::empty_tag, v.tag(3));
+	ASSERT_EQ(typeid(void), v.type(3));
+}
+
+TEST(any_vector, push_back_static_any)
+{
+	static_any<32> a = std::string("foo");
+	static_any<8> b = 42;
+
+	static_any_vector<32> v;
+	v.push_back(a);
+	v.push_back(b);
+
+	ASSERT_EQ("foo", v.get<std::string>(0));
+	ASSERT_EQ(42, v.get<int>(1));
+	ASSERT_EQ("foo", a.get<std::string>());
+}
+
+TEST(any_vector, for_each_count)
+{
+	static_any_vector<16> v;
+	for (int i = 0; i < 10; ++i)
+	{
+		v.push_back(i);
+		v.push_back(static_cast<double>(i));
+	}
+
+	int sum = 0;
+	v.for_each<int>([&sum](int& i) { sum += i; });
+	ASSERT_EQ(45, sum);
+
+	const static_any_vector<16>& cv = v;
+	double dsum = 0.0;
+	cv.for_each<double>([&dsum](const double& d) { dsum += d; });
+	ASSERT_EQ(45.0, dsum);
+
+	ASSERT_EQ(10u, v.count<int>());
+	ASSERT_EQ(10u, v.count<double>());
+	ASSERT_EQ(0u, v.count<std::string>());
+}
+
+TEST(any_vector, dll_types)
+{
+	static_any_vector<16> v;
+	v.push_back(1);
+	v.push_back(get_any_with_int(2));
+	v.push_back(get_any_with_registered_message(3));
+
+	ASSERT_EQ(v.tag(0), v.tag(1));
+	ASSERT_EQ(2u, v.count<int>());
+	ASSERT_EQ(2, v.get<int>(1));
+	ASSERT_EQ(3, v.get<registered_message>(2).i);
+}
+
+TEST(any_vector, append)
+{
+	static_any_vector<32> v;
+	v.append(5, std::string("foo"));
+
+	ASSERT_EQ(5u, v.size());
+	ASSERT_EQ(5u, v.count<std::string>());
+
+	const int values[] = { 1, 2, 3 };
+	v.append(std::begin(values), std::end(values));
+
+	ASSERT_EQ(8u, v.size());
+	ASSERT_EQ(3, v.get<int>(7));
+
+	std::vector<static_any<8>> anys = { 1.0, 2, static_any<8>() };
+	v.append(anys.begin(), anys.end());
+
+	ASSERT_EQ(11u, v.size());
+	ASSERT_EQ(1.0, v.get<double>(8));
+	ASSERT_EQ(4u, v.count<int>());
+}
+
+TEST(any_vector, append_strong_guarantee)
+{
+	static_any_vector<16> v;
+	v.push_back(1);
+
+	Counted::reset_counters();
+	Counted::throw_on_copy = 3;
+
+	const Counted values[] = { 1, 2, 3, 4 };
+	ASSERT_THROW(v.append(std::begin(values), std::end(values)), std::runtime_error);
+	Counted::throw_on_copy = -1;
+
+	ASSERT_EQ(1u, v.size());
+	ASSERT_EQ(3, Counted::copies);
+	ASSERT_EQ(2, Counted::destructions);
+
+	ASSERT_THROW(v.append(3, ThrowingMove(42)), std::runtime_error);
+	ASSERT_EQ(1u, v.size());
+}
+
+TEST(any_vector, push_back_own_element)
+{
+	static_any_vector<32> v;
+	v.push_back(std::string(40, 'a'));
+	ASSERT_EQ(v.size(), v.capacity());
+
+	// the new element is constructed before the old ones are relocated
+	v.push_back(v.get<std::string>(0));
+	ASSERT_EQ(v.size(), v.capacity());
+	v.emplace_back<std::string>(v.get<std::string>(1), 1, 3);
+	ASSERT_LT(v.capacity(), v.size() + 5);
+	v.append(5, v.get<std::string>(2));
+
+	static_any<32> any = std::string(40, 'b');
+	v.push_back(any);
+
+	ASSERT_EQ(9u, v.size());
+	ASSERT_EQ(std::string(40, 'a'), v.get<std::string>(1));
+	ASSERT_EQ("aaa", v.get<std::string>(2));
+	ASSERT_EQ("aaa", v.get<std::string>(7));
+	ASSERT_EQ(std::string(40, 'b'), v.get<std::string>(8));
+}
+
+TEST(any_vector, lifetime)
+{
+	Counted::reset_counters();
+	{
+		static_any_vector<16> v;
+		for (int i = 0; i < 100; ++i)
+		{
+			v.emplace_back<Counted>(i);
+			v.push_back(i);
+		}
+
+		ASSERT_EQ(100, Counted::constructions);
+		ASSERT_EQ(0, Counted::copies);
+		ASSERT_EQ(Counted::moves, Counted::destructions);
+
+		v.pop_back();
+		v.pop_back();
+		ASSERT_EQ(Counted::moves + 1, Counted::destructions);
+		ASSERT_EQ(198u, v.size());
+	}
+	ASSERT_EQ(Counted::constructions + Counted::moves, Counted::destructions);
+}
+
+TEST(any_vector, reserve_strong_guarantee)
+{
+	static_any_vector<32> v;
+	v.push_back(ThrowingMove(1));
+	v.push_back(std::string("foo"));
+	v.emplace_back<ThrowingMove>(42);
+
+	const std::size_t capacity = v.capacity();
+	ASSERT_THROW(v.reserve(capacity + 1), std::runtime_error);
+
+	ASSERT_EQ(capacity, v.capacity());
+	ASSERT_EQ(3u, v.size());
+	ASSERT_EQ("foo", v.get<std::string>(1));
+	ASSERT_EQ(42, v.get<ThrowingMove>(2).value);
+}
+
+TEST(any_vector, copy_move)
+{
+	static_any_vector<32> v;
+	v.push_back(1);
+	v.push_back(std::string("foo"));
+
+	static_any_vector<32> copy(v);
+	ASSERT_EQ(2u, copy.size());
+	ASSERT_EQ("foo", copy.get<std::string>(1));
+
+	static_any_vector<32> moved(std::move(v));
+	ASSERT_EQ(2u, moved.size());
+	ASSERT_TRUE(v.empty());
+
+	v = moved;
+	ASSERT_EQ(1, v.get<int>(0));
+
+	moved = std::move(copy);
+	ASSERT_EQ("foo", moved.get<std::string>(1));
+
+	v.clear();
+	ASSERT_TRUE(v.empty());
+	v.push_back(2.0);
+	ASSERT_EQ(2.0, v.get<double>(0));
+}
+
+TEST(any_vector, copy_move_only)
+{
+	static_any_vector<16> v;
+	v.push_back(std::unique_ptr<int>(new int(1)));
+	v.push_back(2);
+
+	v.reserve(100);
+	ASSERT_EQ(1, *v.get<std::unique_ptr<int>>(0));
+
+	ASSERT_THROW(static_any_vector<16>{v}, bad_any_copy);
+}
+
+namespace {
+
+std::size_t allocated_bytes = 0;
+
+template <class T>
+struct TrackingAllocator
+{
+	using value_type = T;
+
+	TrackingAllocator() = default;
+
+	template <class U>
+	TrackingAllocator(const TrackingAllocator<U>&) {}
+
+	T* allocate(std::size_t n)
+	{
+		allocated_bytes += n * sizeof(T);
+		return static_cast<T*>(::operator new(n * sizeof(T)));
+	}
+
+	void deallocate(T* p, std::size_t n)
+	{
+		allocated_bytes -= n * sizeof(T);
+		::operator delete(p);
+	}
+};
+
+template <class T, class U>
+bool operator==(const TrackingAllocator<T>&, const TrackingAllocator<U>&) { return true; }
+template <class T, class U>
+bool operator!=(const TrackingAllocator<T>&, const TrackingAllocator<U>&) { return false; }
+
+}
+
+TEST(any_vector, allocator)
+{
+	{
+		static_any_vector<32, 8, TrackingAllocator<char>> v;
+		v.push_back(std::string("foo"));
+		v.append(100, 1);
+
+		ASSERT_LE(v.capacity() * 32, allocated_bytes);
+
+		auto copy = v;
+		ASSERT_EQ("foo", copy.get<std::string>(0));
+	}
+	ASSERT_EQ(0u, allocated_bytes);
+}
+
+TEST(any_vector, count_find_all)
+{
+	// every size from empty to a few vectors of tags, to cover the scalar tail after the SIMD loop
+	for (std::size_t size = 0; size < 70; ++size)
+	{
+		static_any_vector<16> v;
+		std::vector<std::size_t> expected;
+
+		for (std::size_t i = 0; i < size; ++i)
+		{
+			if (i % 3 == 0 || i % 7 == 0)
+			{
+				v.push_back(static_cast<int>(i));
+				expected.push_back(i);
+			}
+			else
+			{
+				v.push_back(static_cast<double>(i));
+			}
+		}
+
+		ASSERT_EQ(expected.size(), v.count<int>());
+
+		std::vector<std::size_t> found;
+		v.find_all<int>(std::back_inserter(found));
+		ASSERT_EQ(expected, found);
+
+		int visited = 0;
+		v.for_each<int>([&](int i) { ASSERT_EQ(expected[static_cast<std::size_t>(visited++)], static_cast<std::size_t>(i)); });
+	}
+
+	static_any_vector<16> v;
+	v.append(20, 1.0);
+	ASSERT_EQ(0u, v.count<int>());
+	std::vector<std::size_t> found;
+	v.find_all<int>(std::back_inserter(found));
+	ASSERT_TRUE(found.empty());
+}
+
+TEST(any_vector, partition)
+{
+	static_any_vector<32> v;
+	for (int i = 0; i < 20; ++i)
+	{
+		if (i % 4 == 0)
+			v.push_back(std::to_string(i));
+		else
+			v.push_back(i);
+	}
+	v.push_back(static_any<8>());
+	v.push_back(get_any_with_int(100));
+
+	ASSERT_EQ(5u, v.partition<std::string>());
+	ASSERT_EQ(22u, v.size());
+
+	for (std::size_t i = 0; i < 5; ++i)
+		ASSERT_EQ(std::to_string(4 * i), v.get<std::string>(i));
+
+	std::vector<int> ints;
+	v.for_each<int>([&ints](int i) { ints.push_back(i); });
+	ASSERT_EQ((std::vector<int>{1, 2, 3, 5, 6, 7, 9, 10, 11, 13, 14, 15, 17, 18, 19, 100}), ints);
+	ASSERT_EQ(static_any_vector<32>::empty_tag, v.tag(20));
+
+	// already partitioned, or no element of the type
+	ASSERT_EQ(5u, v.partition<std::string>());
+	ASSERT_EQ(0u, v.partition<float>());
+	ASSERT_EQ("0", v.get<std::string>(0));
+
+	ASSERT_EQ(16u, v.partition<int>());
+	ASSERT_EQ(1, v.get<int>(0));
+	ASSERT_EQ("0", v.get<std::string>(16));
+}
+
+TEST(any_vector, partition_strong_guarantee)
+{
+	static_any_vector<32> v;
+	v.reserve(8);
+	v.push_back(1);
+	v.push_back(ThrowingMove(1));
+	v.push_back(std::string("foo"));
+	v.emplace_back<ThrowingMove>(42);
+	v.push_back(2);
+
+	ASSERT_THROW(v.partition<int>(), std::runtime_error);
+
+	ASSERT_EQ(5u, v.size());
+	ASSERT_EQ(1, v.get<int>(0));
+	ASSERT_EQ(1, v.get<ThrowingMove>(1).value);
+	ASSERT_EQ("foo", v.get<std::string>(2));
+	ASSERT_EQ(2, v.get<int>(4));
+
+	Counted::reset_counters();
+	{
+		static_any_vector<16> c;
+		c.emplace_back<Counted>(1);
+		c.push_back(2);
+		c.emplace_back<Counted>(3);
+
+		const int moves = Counted::moves;
+		ASSERT_EQ(1u, c.partition<int>());
+		ASSERT_EQ(moves + 2, Counted::moves);
+		ASSERT_EQ(0, Counted::copies);
+		ASSERT_EQ(3, c.get<Counted>(2).value);
+	}
+	ASSERT_EQ(Counted::constructions + Counted::moves, Counted::destructions);
+}
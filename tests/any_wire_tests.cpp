@@ -0,0 +1,122 @@
+#include "../any_wire.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <vector>
+
+// the values are identified by the hash of the name of their type: their types can not be in an anonymous namespace
+namespace wire_tests {
+
+struct Trade
+{
+	double price;
+	int quantity;
+};
+
+struct Quote
+{
+	double bid;
+	double ask;
+};
+
+}
+
+using wire_tests::Trade;
+using wire_tests::Quote;
+using Event = static_any_tagged_t<16>;
+
+TEST(any_tagged, trivially_copyable)
+{
+	static_assert(detail::static_any::is_trivially_copyable<Event>::value, "static_any_tagged_t has to be trivially copyable");
+	static_assert(sizeof(Event) == 16 + sizeof(static_any_type_id_t), "no padding");
+}
+
+TEST(any_tagged, type_id)
+{
+	Event e;
+	ASSERT_TRUE(e.empty());
+	ASSERT_EQ(static_any_type_id<void>::value, e.type_id());
+
+	e = Trade{1.5, 100};
+	ASSERT_TRUE(e.has<Trade>());
+	ASSERT_TRUE(e.has<const Trade>());
+	ASSERT_FALSE(e.has<Quote>());
+	ASSERT_EQ(100, e.get<Trade>().quantity);
+	ASSERT_EQ(nullptr, e.try_get<Quote>());
+	ASSERT_EQ(static_any_type_id<Trade>::value, e.type_id());
+
+	Event copy = e;
+	ASSERT_EQ(1.5, copy.try_get<Trade>()->price);
+
+	e.reset();
+	ASSERT_TRUE(e.empty());
+}
+
+TEST(any_tagged, zeroed_padding)
+{
+	using Small = static_any_tagged_t<12>;
+	static_assert(sizeof(Small) > 12 + sizeof(static_any_type_id_t), "padding before the id");
+	const std::size_t id_offset = sizeof(Small) - sizeof(static_any_type_id_t);
+
+	alignas(Small) unsigned char bytes[sizeof(Small)];
+
+	std::memset(bytes, 0xff, sizeof(bytes));
+	new(bytes) Small();
+	for (std::size_t i = 0; i < id_offset; ++i)
+		ASSERT_EQ(0, bytes[i]);
+
+	std::memset(bytes, 0xff, sizeof(bytes));
+	const Small* small = new(bytes) Small(std::uint8_t{7});
+	ASSERT_EQ(7, bytes[0]);
+	for (std::size_t i = 1; i < id_offset; ++i)
+		ASSERT_EQ(0, bytes[i]);
+
+	// decayed, as by the constructor
+	ASSERT_TRUE(small->has<const std::uint8_t&>());
+}
+
+TEST(any_wire, round_trip)
+{
+	std::vector<Event> events = { Trade{1.0, 10}, Quote{0.9, 1.1}, Event(), Trade{2.0, 20} };
+
+	std::vector<Event> storage(serialized_size<Event>(events.size()) / sizeof(Event) + 1);
+	void* buffer = storage.data();
+	const std::size_t size = storage.size() * sizeof(Event);
+
+	ASSERT_EQ(serialized_size<Event>(events.size()), serialize(events.data(), events.size(), buffer, size));
+
+	std::size_t count = 0;
+	const Event* view = deserialize_view<Event>(buffer, size, count);
+	ASSERT_NE(nullptr, view);
+	ASSERT_EQ(4u, count);
+	ASSERT_EQ(10, view[0].get<Trade>().quantity);
+	ASSERT_EQ(1.1, view[1].get<Quote>().ask);
+	ASSERT_TRUE(view[2].empty());
+
+	Event copies[2];
+	ASSERT_EQ(2u, deserialize(buffer, size, copies, 2));
+	ASSERT_TRUE(copies[1].has<Quote>());
+}
+
+TEST(any_wire, invalid_buffers)
+{
+	Event events[] = { Trade{1.0, 10} };
+	std::vector<Event> storage(8);
+	void* buffer = storage.data();
+
+	ASSERT_EQ(0u, serialize(events, 1, buffer, 16));
+
+	const std::size_t size = serialize(events, 1, buffer, storage.size() * sizeof(Event));
+	ASSERT_NE(0u, size);
+
+	std::size_t count = 0;
+	ASSERT_EQ(nullptr, deserialize_view<Event>(buffer, size - 1, count));
+	ASSERT_EQ(nullptr, deserialize_view<static_any_tagged_t<32>>(buffer, size, count));
+	ASSERT_EQ(nullptr, deserialize_view<Event>(static_cast<char*>(buffer) + 1, size, count));
+
+	Event copy;
+	ASSERT_EQ(0u, deserialize(buffer, 8, &copy, 1));
+}
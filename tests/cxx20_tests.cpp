@@ -0,0 +1,135 @@
+// built in C++20, in its own executable
+#include "../any.hpp"
+#include "../any_vector.hpp"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <memory_resource>
+#include <string>
+
+#if !defined(STATIC_ANY_HAS_CONSTEXPR_T)
+# error "static_any_t is not constexpr in C++20 with this standard library"
+#endif
+
+namespace {
+
+struct IntPair
+{
+	int a;
+	int b;
+};
+
+constexpr static_any_t<8> constant_table[] = { 1, 2.5, IntPair{3, 4} };
+
+// counts the blocks it holds
+class CountingResource : public std::pmr::memory_resource
+{
+public:
+	int blocks = 0;
+
+private:
+	void* do_allocate(std::size_t bytes, std::size_t alignment) override
+	{
+		++blocks;
+		return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+	}
+
+	void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override
+	{
+		--blocks;
+		std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+	}
+
+	bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+};
+
+using PmrAllocator = std::pmr::polymorphic_allocator<char>;
+using PmrAny = small_any<16, PmrAllocator>;
+using Array64 = std::array<char, 64>;
+using PmrVector = static_any_vector<32, 8, PmrAllocator>;
+
+PmrVector make_vector(CountingResource& resource)
+{
+	PmrVector v{PmrAllocator(&resource)};
+	v.push_back(1);
+	v.push_back(std::string(40, 'a'));
+	return v;
+}
+
+}
+
+TEST(any_t, constant_initialization)
+{
+	ASSERT_EQ(1, constant_table[0].get<int>());
+	ASSERT_EQ(2.5, constant_table[1].get<double>());
+	ASSERT_EQ(4, constant_table[2].get<IntPair>().b);
+}
+
+// polymorphic_allocator is not propagated, and can not be assigned
+TEST(small_any, polymorphic_allocator)
+{
+	CountingResource first;
+	CountingResource second;
+
+	PmrAny a{PmrAllocator(&first)};
+	a = 5;
+	a = Array64{{'a'}};
+	ASSERT_EQ(1, first.blocks);
+
+	// moved to an allocation of the resource of b
+	PmrAny b{PmrAllocator(&second)};
+	b = std::move(a);
+	ASSERT_TRUE(a.empty());
+	ASSERT_EQ('a', b.get<Array64>()[0]);
+	ASSERT_EQ(0, first.blocks);
+	ASSERT_EQ(1, second.blocks);
+
+	// stolen, with the same resource
+	PmrAny c{PmrAllocator(&second)};
+	c = std::move(b);
+	ASSERT_EQ(1, second.blocks);
+	ASSERT_EQ(&second, c.get_allocator().resource());
+
+	a = c;
+	ASSERT_EQ(&first, a.get_allocator().resource());
+	ASSERT_EQ(1, first.blocks);
+	ASSERT_EQ('a', a.get<Array64>()[0]);
+}
+
+// the elements are copied or moved to the storage of the vector, which keeps its resource
+TEST(any_vector, polymorphic_allocator)
+{
+	CountingResource first;
+	CountingResource second;
+
+	PmrVector v = make_vector(first);
+	PmrVector w{PmrAllocator(&second)};
+
+	w = v;
+	ASSERT_EQ(&second, w.get_allocator().resource());
+	ASSERT_EQ(2u, w.size());
+	ASSERT_EQ(std::string(40, 'a'), w.get<std::string>(1));
+	ASSERT_GT(second.blocks, 0);
+
+	w = std::move(v);
+	ASSERT_TRUE(v.empty());
+	ASSERT_EQ(&second, w.get_allocator().resource());
+	ASSERT_EQ(1, w.get<int>(0));
+
+	PmrVector x = make_vector(first);
+	x.push_back(2.5);
+	w.swap(x);
+	ASSERT_EQ(&second, w.get_allocator().resource());
+	ASSERT_EQ(&first, x.get_allocator().resource());
+	ASSERT_EQ(3u, w.size());
+	ASSERT_EQ(2.5, w.get<double>(2));
+	ASSERT_EQ(2u, x.size());
+	ASSERT_EQ(std::string(40, 'a'), x.get<std::string>(1));
+
+	// stolen, with the same resource
+	PmrVector y{PmrAllocator(&second)};
+	y = std::move(w);
+	ASSERT_EQ(3u, y.size());
+	ASSERT_TRUE(w.empty());
+}
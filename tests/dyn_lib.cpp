@@ -5,3 +5,9 @@ static_any<16> get_any_with_int(int x)
 	static_any<16> a = x;
 	return a;
 }
+
+static_any<16> get_any_with_registered_message(int x)
+{
+	static_any<16> a = registered_message{x};
+	return a;
+}
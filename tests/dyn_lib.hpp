@@ -2,4 +2,20 @@
 
 #include "../any.hpp"
 
-static_any<16> get_any_with_int(int x);
+struct registered_message
+{
+	int i;
+};
+
+template <> struct static_any_type_id<registered_message> : std::integral_constant<static_any_type_id_t, 42> {};
+
+// the library may be built with hidden visibility, so that its vtables are not merged with the ones of the program
+#if defined(__GNUC__)
+# define DYN_LIB_EXPORT __attribute__((visibility("default")))
+#else
+# define DYN_LIB_EXPORT
+#endif
+
+DYN_LIB_EXPORT static_any<16> get_any_with_int(int x);
+
+DYN_LIB_EXPORT static_any<16> get_any_with_registered_message(int x);
@@ -0,0 +1,106 @@
+// built with STATIC_ANY_INSTRUMENTATION defined, in its own executable
+#include "../any.hpp"
+#include "../any_vector.hpp"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+namespace {
+
+struct Message
+{
+	std::string text;
+};
+
+static_any_stats stats_of(const std::type_info& type)
+{
+	static_any_stats found = { typeid(void), 0, 0, 0, 0, 0, 0 };
+	static_any_for_each_stats([&](const static_any_stats& stats)
+	{
+		if (stats.type == type)
+			std::memcpy(static_cast<void*>(&found), &stats, sizeof(stats));
+	});
+	return found;
+}
+
+}
+
+TEST(instrumentation, operations)
+{
+	static_any_reset_stats();
+	{
+		Message m{"foo"};
+		static_any<64> a = m;
+		static_any<64> b = std::move(a);
+		static_any<64> c = b;
+
+		// the copy of a std::string may throw: the current value is backed up
+		c = b;
+	}
+
+	const static_any_stats stats = stats_of(typeid(Message));
+	ASSERT_EQ(typeid(Message), stats.type);
+	EXPECT_EQ(3u, stats.copies);
+	EXPECT_EQ(2u, stats.moves);
+	EXPECT_EQ(1u, stats.backups);
+	EXPECT_EQ(stats.copies + stats.moves, stats.destroys);
+}
+
+TEST(instrumentation, failed_casts)
+{
+	static_any_reset_stats();
+
+	static_any<16> a = 1;
+	EXPECT_THROW(a.get<double>(), bad_any_cast);
+	EXPECT_THROW(a.get<float>(), bad_any_cast);
+	EXPECT_EQ(nullptr, a.try_get<float>());
+
+	EXPECT_EQ(2u, stats_of(typeid(int)).failed_casts);
+}
+
+TEST(instrumentation, visit_without_slow_checks)
+{
+	static_any_reset_stats();
+
+	static_any<16> a = 1.f;
+	EXPECT_FALSE((visit<double, int, long, char, short, unsigned>(a, [](const auto&) {})));
+
+	a = 2u;
+	EXPECT_TRUE((visit<double, int, long, char, short, unsigned>(a, [](const auto&) {})));
+
+	// the ids are searched first: another type is never checked against each candidate
+	EXPECT_EQ(0u, stats_of(typeid(float)).slow_type_checks);
+	EXPECT_EQ(0u, stats_of(typeid(unsigned)).slow_type_checks);
+}
+
+TEST(instrumentation, ranges)
+{
+	static_any_reset_stats();
+	{
+		static_any_vector<64> v;
+		v.append(10, Message{"foo"});
+		static_any_vector<64> copy(v);
+	}
+
+	// the appended values are constructed in place: only the copy of the vector is counted, in one batch
+	const static_any_stats stats = stats_of(typeid(Message));
+	EXPECT_EQ(10u, stats.copies);
+	EXPECT_EQ(20u, stats.destroys);
+}
+
+TEST(instrumentation, dump)
+{
+	static_any<16> a = 1;
+	static_any<16> b = a;
+
+	std::FILE* out = std::tmpfile();
+	ASSERT_NE(nullptr, out);
+	static_any_dump_stats(out);
+
+	std::rewind(out);
+	char header[32] = {};
+	ASSERT_NE(nullptr, std::fgets(header, sizeof(header), out));
+	EXPECT_EQ(0, std::strncmp("type", header, 4));
+	std::fclose(out);
+}
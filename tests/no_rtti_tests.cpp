@@ -0,0 +1,136 @@
+// built with -fno-rtti, in its own executable, against dyn_lib_no_rtti
+#include "../any.hpp"
+#include "../any_vector.hpp"
+#include "dyn_lib.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+
+namespace {
+
+struct Message
+{
+	int i;
+};
+
+}
+
+static_assert(std::is_same<const static_any_type_info&, decltype(static_any<8>().type())>::value, "");
+
+TEST(no_rtti, type_names)
+{
+	static_any<32> a;
+	EXPECT_TRUE(a.type() == static_any_typeid<void>());
+	EXPECT_STREQ("void", a.type().name());
+
+	a = 1;
+	EXPECT_TRUE(a.type() == static_any_typeid<int>());
+	EXPECT_TRUE(a.type() == static_any_typeid<const int>());
+	EXPECT_TRUE(a.type() != static_any_typeid<long>());
+	EXPECT_STREQ("int", a.type().name());
+	EXPECT_EQ(static_any_type_id<int>::value, a.type().id());
+
+	a = std::make_pair(1, 2.0);
+	EXPECT_STREQ("std::pair<int, double>", a.type().name());
+
+	a = Message{3};
+	EXPECT_NE(nullptr, std::strstr(a.type().name(), "Message"));
+}
+
+TEST(no_rtti, casts)
+{
+	static_any<32> a = std::string("foo");
+	EXPECT_TRUE(a.has<std::string>());
+	EXPECT_FALSE(a.has<int>());
+	EXPECT_EQ("foo", a.get<std::string>());
+	EXPECT_EQ(nullptr, any_cast<int>(&a));
+
+	try
+	{
+		any_cast<double>(a);
+		FAIL();
+	}
+	catch (const bad_any_cast& e)
+	{
+		EXPECT_TRUE(e.stored_type() == static_any_typeid<std::string>());
+		EXPECT_TRUE(e.target_type() == static_any_typeid<double>());
+		EXPECT_NE(nullptr, std::strstr(e.what(), "basic_string"));
+		EXPECT_NE(nullptr, std::strstr(e.what(), "to double"));
+	}
+
+	static_any<16> b = std::unique_ptr<int>(new int(1));
+	try
+	{
+		static_any<16> c(b);
+		FAIL();
+	}
+	catch (const bad_any_copy& e)
+	{
+		EXPECT_TRUE(e.stored_type() == static_any_typeid<std::unique_ptr<int>>());
+	}
+}
+
+TEST(no_rtti, across_dll)
+{
+	auto a = get_any_with_int(7);
+	EXPECT_TRUE(a.has<int>());
+	EXPECT_FALSE(a.has<long>());
+	EXPECT_EQ(7, a.get<int>());
+	EXPECT_TRUE(a.type() == static_any_typeid<int>());
+	EXPECT_STREQ("int", a.type().name());
+	EXPECT_THROW(a.get<std::string>(), bad_any_cast);
+
+	auto b = get_any_with_registered_message(3);
+	EXPECT_EQ(3, b.get<registered_message>().i);
+	EXPECT_EQ(42u, b.type().id());
+
+	// the vtables of the library are hidden: a const static_any checks a const int against them
+	const static_any<16>& const_a = a;
+	EXPECT_EQ(7, const_a.get<int>());
+	EXPECT_EQ(7, *any_cast<const int>(&const_a));
+
+	static_any<16> c = 7;
+	EXPECT_TRUE(a == c);
+	EXPECT_TRUE(visit<int>(a, [](int i) { EXPECT_EQ(7, i); }));
+}
+
+// with USE_TYPE_ID, the types of the same name are told apart by their vtables
+TEST(no_rtti, lambdas_with_the_same_name)
+{
+	const int i = 1;
+	const double d = 2.0;
+	auto l1 = [i]() { return i; };
+	auto l2 = [d]() { return d; };
+
+	static_any<16> a = l1;
+	EXPECT_TRUE(a.has<decltype(l1)>());
+	EXPECT_FALSE(a.has<decltype(l2)>());
+	EXPECT_THROW(a.get<decltype(l2)>(), bad_any_cast);
+	EXPECT_FALSE(visit<decltype(l2)>(a, [](const auto&) {}));
+
+	static_any<16> b = l2;
+	EXPECT_TRUE(a < b || b < a);
+
+	static_any_vector<16> v;
+	v.push_back(l1);
+	v.push_back(l2);
+	EXPECT_NE(v.tag(0), v.tag(1));
+	EXPECT_EQ(1u, v.count<decltype(l2)>());
+}
+
+TEST(no_rtti, vector)
+{
+	static_any_vector<16> v;
+	v.push_back(1);
+	v.push_back(get_any_with_int(2));
+	v.push_back(2.5);
+
+	EXPECT_EQ(v.tag(0), v.tag(1));
+	EXPECT_EQ(2u, v.count<int>());
+	EXPECT_STREQ("double", v.type(2).name());
+	EXPECT_THROW(v.get<int>(2), bad_any_cast);
+}
@@ -3,6 +3,9 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <unordered_set>
+
 struct A
 {
 	explicit A(int i) :
@@ -39,6 +42,36 @@ TEST(any, test_sizeof)
 	ASSERT_EQ(16 + sizeof(std::ptrdiff_t), sizeof(a));
 }
 
+struct alignas(32) OverAligned
+{
+	double d[4];
+};
+
+TEST(any, alignment)
+{
+	static_any<32, 32> a;
+	ASSERT_EQ(32u, a.alignment());
+	ASSERT_EQ(0, alignof(decltype(a)) % 32);
+
+	a = OverAligned{{1., 2., 3., 4.}};
+	ASSERT_EQ(0u, reinterpret_cast<std::uintptr_t>(&a.get<OverAligned>()) % 32);
+	ASSERT_EQ(4., a.get<OverAligned>().d[3]);
+
+	static_any<32, 32> b = a;
+	ASSERT_EQ(0u, reinterpret_cast<std::uintptr_t>(&b.get<OverAligned>()) % 32);
+}
+
+TEST(any, default_alignment)
+{
+	static_any<16> a = .5;
+	ASSERT_LE(alignof(double), a.alignment());
+	ASSERT_EQ(0u, reinterpret_cast<std::uintptr_t>(&a.get<double>()) % alignof(double));
+
+	// a less aligned any can be converted to a more aligned one
+	static_any<16, 16> b = a;
+	ASSERT_EQ(.5, b.get<double>());
+}
+
 TEST(any, capacity)
 {
 	static_any<32> a;
@@ -85,15 +118,15 @@ TEST(any, has)
 	ASSERT_FALSE(a.has<double>());
 }
 
-template <std::size_t Index>
+template <std::size_t Index, bool Noexcept = false>
 class CallCounter
 {
 public:
 	CallCounter() { ++constructions; }
-	CallCounter(const CallCounter&) { ++copy_constructions; }
-	CallCounter& operator=(const CallCounter&) { ++copy_constructions; return *this; }
-	CallCounter(CallCounter&&) { ++move_constructions; }
-	CallCounter& operator=(CallCounter&&) { ++move_constructions; return *this;  }
+	CallCounter(const CallCounter&) noexcept(Noexcept) { ++copy_constructions; }
+	CallCounter& operator=(const CallCounter&) noexcept(Noexcept) { ++copy_constructions; return *this; }
+	CallCounter(CallCounter&&) noexcept(Noexcept) { ++move_constructions; }
+	CallCounter& operator=(CallCounter&&) noexcept(Noexcept) { ++move_constructions; return *this;  }
 	~CallCounter() { ++destructions; }
 
 	static void reset_counters()
@@ -110,10 +143,13 @@ public:
 	static int destructions;
 };
 
-template <std::size_t Index> int CallCounter<Index>::constructions = 0;
-template <std::size_t Index> int CallCounter<Index>::copy_constructions = 0;
-template <std::size_t Index> int CallCounter<Index>::move_constructions = 0;
-template <std::size_t Index> int CallCounter<Index>::destructions = 0;
+template <std::size_t Index, bool Noexcept> int CallCounter<Index, Noexcept>::constructions = 0;
+template <std::size_t Index, bool Noexcept> int CallCounter<Index, Noexcept>::copy_constructions = 0;
+template <std::size_t Index, bool Noexcept> int CallCounter<Index, Noexcept>::move_constructions = 0;
+template <std::size_t Index, bool Noexcept> int CallCounter<Index, Noexcept>::destructions = 0;
+
+template <std::size_t Index>
+using NoexceptCallCounter = CallCounter<Index, true>;
 
 TEST(any, move_construct)
 {
@@ -212,6 +248,42 @@ TEST(any, value_move_assignment)
 	ASSERT_EQ(0, CallCounter<1>::destructions);
 }
 
+TEST(any, nothrow_value_move_assignment_no_backup)
+{
+	static_any<16> a = CallCounter<0>();
+	NoexceptCallCounter<1> counter;
+
+	CallCounter<0>::reset_counters();
+	NoexceptCallCounter<1>::reset_counters();
+
+	a = std::move(counter);
+
+	ASSERT_EQ(0, CallCounter<0>::copy_constructions);
+	ASSERT_EQ(0, CallCounter<0>::move_constructions);
+	ASSERT_EQ(1, CallCounter<0>::destructions);
+
+	ASSERT_EQ(0, NoexceptCallCounter<1>::copy_constructions);
+	ASSERT_EQ(1, NoexceptCallCounter<1>::move_constructions);
+	ASSERT_EQ(0, NoexceptCallCounter<1>::destructions);
+}
+
+TEST(any, nothrow_value_copy_assignment_no_backup)
+{
+	static_any<16> a = CallCounter<0>();
+	NoexceptCallCounter<1> counter;
+
+	CallCounter<0>::reset_counters();
+	NoexceptCallCounter<1>::reset_counters();
+
+	a = counter;
+
+	ASSERT_EQ(0, CallCounter<0>::copy_constructions);
+	ASSERT_EQ(1, CallCounter<0>::destructions);
+
+	ASSERT_EQ(1, NoexceptCallCounter<1>::copy_constructions);
+	ASSERT_EQ(0, NoexceptCallCounter<1>::move_constructions);
+}
+
 TEST(any, any_move_ctor)
 {
 	CallCounter<0> counter;
@@ -268,6 +340,41 @@ TEST(any, any_move_assignment)
 	ASSERT_EQ(2, CallCounter<1>::destructions);
 }
 
+TEST(any, nothrow_any_move_assignment_no_backup)
+{
+	static_any<16> a = NoexceptCallCounter<0>();
+	static_any<16> b = CallCounter<1>();
+
+	NoexceptCallCounter<0>::reset_counters();
+	CallCounter<1>::reset_counters();
+
+	b = std::move(a);
+
+	ASSERT_EQ(0, NoexceptCallCounter<0>::copy_constructions);
+	ASSERT_EQ(1, NoexceptCallCounter<0>::move_constructions);
+
+	ASSERT_EQ(0, CallCounter<1>::copy_constructions);
+	ASSERT_EQ(0, CallCounter<1>::move_constructions);
+	ASSERT_EQ(1, CallCounter<1>::destructions);
+}
+
+TEST(any, nothrow_any_copy_assignment_no_backup)
+{
+	static_any<16> a = NoexceptCallCounter<0>();
+	static_any<16> b = CallCounter<1>();
+
+	NoexceptCallCounter<0>::reset_counters();
+	CallCounter<1>::reset_counters();
+
+	b = a;
+
+	ASSERT_EQ(1, NoexceptCallCounter<0>::copy_constructions);
+	ASSERT_EQ(0, NoexceptCallCounter<0>::move_constructions);
+
+	ASSERT_EQ(0, CallCounter<1>::copy_constructions);
+	ASSERT_EQ(1, CallCounter<1>::destructions);
+}
+
 TEST(any, not_empty_after_assignment)
 {
 	static_any<16> a;
@@ -382,6 +489,28 @@ TEST(any, any_to_bigger_any_copy)
 	ASSERT_EQ(1, b.get<int>());
 }
 
+struct TrivialStruct
+{
+	int i;
+	double d;
+};
+
+TEST(any, trivially_copyable_copy_and_move)
+{
+	static_any<16> a = TrivialStruct{7, .5};
+	static_any<32> b(a);
+	static_any<32> c(std::move(b));
+	static_any<32> d;
+	d = c;
+
+	EXPECT_EQ(7, d.get<TrivialStruct>().i);
+	EXPECT_EQ(.5, d.get<TrivialStruct>().d);
+	EXPECT_EQ(sizeof(TrivialStruct), d.size());
+
+	d = std::move(a);
+	EXPECT_EQ(7, d.get<TrivialStruct>().i);
+}
+
 struct InitCtor
 {
 	InitCtor() = default;
@@ -424,6 +553,41 @@ TEST(any, destroyed_after_emplace)
 	EXPECT_EQ(1, CallCounter<0>::destructions);
 }
 
+TEST(any, in_place_construction)
+{
+	CallCounter<0>::reset_counters();
+
+	{
+		static_any<32> a(static_any_in_place_type<CallCounter<0>>);
+		ASSERT_TRUE(a.has<CallCounter<0>>());
+	}
+
+	EXPECT_EQ(1, CallCounter<0>::constructions);
+	EXPECT_EQ(0, CallCounter<0>::copy_constructions);
+	EXPECT_EQ(0, CallCounter<0>::move_constructions);
+	EXPECT_EQ(1, CallCounter<0>::destructions);
+
+	static_any<32> b(static_any_in_place_type<InitCtor>, 77, 88);
+	EXPECT_EQ(77, b.get<InitCtor>().x);
+	EXPECT_EQ(88, b.get<InitCtor>().y);
+
+	static_any<32> c(static_any_in_place_type<std::string>, 3u, 'a');
+	EXPECT_EQ("aaa", c.get<std::string>());
+
+	static_unique_any<16> u(static_any_in_place_type<std::unique_ptr<int>>, new int(4));
+	EXPECT_EQ(4, *u.get<std::unique_ptr<int>>());
+}
+
+TEST(any, make_static_any)
+{
+	auto a = make_static_any<32, InitCtor>(1, 3);
+	static_assert(std::is_same<decltype(a), static_any<32>>::value, "make_static_any returns a static_any<32>");
+	EXPECT_EQ(3, a.get<InitCtor>().y);
+
+	auto b = make_static_any<16, int>();
+	EXPECT_EQ(0, b.get<int>());
+}
+
 TEST(any, any_cast_pointer_correct_type)
 {
 	static_any<16> a(7);
@@ -494,6 +658,42 @@ TEST(any, any_cast_reference_wrong_type_from_to)
 	}
 }
 
+TEST(any, bad_any_cast_what)
+{
+	static_any<16> a(7);
+
+	try {
+		a.get<float>();
+		FAIL();
+	}
+	catch(bad_any_cast& ex) {
+		const std::string what = ex.what();
+		EXPECT_NE(std::string::npos, what.find(typeid(int).name()));
+		EXPECT_NE(std::string::npos, what.find(typeid(float).name()));
+	}
+}
+
+TEST(any, try_get)
+{
+	static_any<16> a(7);
+	const auto& ca = a;
+
+	ASSERT_NE(nullptr, a.try_get<int>());
+	EXPECT_EQ(7, *a.try_get<int>());
+	EXPECT_EQ(7, *ca.try_get<int>());
+	EXPECT_EQ(nullptr, a.try_get<float>());
+
+	*a.try_get<int>() = 8;
+	EXPECT_EQ(8, a.get<int>());
+
+	a.reset();
+	EXPECT_EQ(nullptr, a.try_get<int>());
+
+	small_any<16> b(7);
+	EXPECT_EQ(7, *b.try_get<int>());
+	EXPECT_EQ(nullptr, b.try_get<float>());
+}
+
 TEST(any, query_type)
 {
 	static_any<32> a(7);
@@ -501,6 +701,14 @@ TEST(any, query_type)
 
 	a = std::string("f00");
 	ASSERT_EQ(typeid(std::string), a.type());
+
+	// read from the vtable: the very same object as static_any_typeid
+	const static_any<32> b(7u);
+	ASSERT_EQ(&static_any_typeid<const unsigned>(), &b.type());
+
+	a.reset();
+	ASSERT_EQ(typeid(void), a.type());
+	ASSERT_EQ(0u, a.size());
 }
 
 TEST(any, reset_empty)
@@ -519,6 +727,34 @@ TEST(any, reset_has)
 	ASSERT_FALSE(a.has<int>());
 }
 
+TEST(any, types_without_unique_name)
+{
+	struct Local {};
+	const int i = 1;
+	const double d = 2.0;
+	auto l1 = [i]() { return i; };
+	auto l2 = [d]() { return d; };
+
+	// gcc names both lambdas "TestBody()::<lambda()>": their type ids are the same
+	static_assert(!detail::static_any::has_unique_type_id<decltype(l1)>::value, "");
+	static_assert(!detail::static_any::has_unique_type_id<Local>::value, "");
+	static_assert(!detail::static_any::has_unique_type_id<std::pair<int, Local>>::value, "");
+	static_assert(detail::static_any::has_unique_type_id<std::pair<int, std::string>>::value, "");
+	static_assert(detail::static_any::has_unique_type_id<registered_message>::value, "");
+
+	static_any<16> a = l1;
+	EXPECT_TRUE(a.has<decltype(l1)>());
+	EXPECT_FALSE(a.has<decltype(l2)>());
+	EXPECT_EQ(nullptr, a.try_get<decltype(l2)>());
+	EXPECT_THROW(a.get<decltype(l2)>(), bad_any_cast);
+	EXPECT_EQ(1, a.get<decltype(l1)>()());
+
+	a = l2;
+	EXPECT_TRUE(a.has<decltype(l2)>());
+	EXPECT_FALSE(a.has<decltype(l1)>());
+	EXPECT_FALSE(a.has<Local>());
+}
+
 TEST(any, type_identification_across_dll)
 {
 	auto a = get_any_with_int(7);
@@ -530,12 +766,177 @@ TEST(any, type_identification_across_dll)
 	EXPECT_THROW(a.get<std::string>(), bad_any_cast);
 }
 
+TEST(any, move_only_type)
+{
+	static_any<16> a = std::make_unique<int>(7);
+	ASSERT_EQ(7, *a.get<std::unique_ptr<int>>());
+
+	static_any<16> b = std::move(a);
+	ASSERT_EQ(7, *b.get<std::unique_ptr<int>>());
+	ASSERT_EQ(nullptr, a.get<std::unique_ptr<int>>());
+
+	a = std::make_unique<int>(8);
+	b = std::move(a);
+	ASSERT_EQ(8, *b.get<std::unique_ptr<int>>());
+}
+
+TEST(any, move_only_type_copy)
+{
+	static_any<16> a = std::make_unique<int>(7);
+	EXPECT_THROW(static_any<16> b(a), bad_any_copy);
+
+	static_any<16> b = 1234;
+	EXPECT_THROW(b = a, bad_any_copy);
+	EXPECT_EQ(1234, b.get<int>());
+}
+
+TEST(unique_any, move_only_type)
+{
+	static_assert(!std::is_copy_constructible<static_unique_any<16>>::value, "move only");
+	static_assert(!std::is_copy_assignable<static_unique_any<16>>::value, "move only");
+
+	static_unique_any<16> a = std::make_unique<int>(7);
+	ASSERT_TRUE(a.has<std::unique_ptr<int>>());
+
+	static_unique_any<32> b = std::move(a);
+	ASSERT_EQ(7, *any_cast<std::unique_ptr<int>>(b));
+
+	static_unique_any<32> c;
+	c = std::move(b);
+	ASSERT_EQ(7, *c.get<std::unique_ptr<int>>());
+	ASSERT_EQ(nullptr, any_cast<int>(&c));
+
+	c = 5;
+	ASSERT_EQ(5, any_cast<int>(c));
+	c.reset();
+	ASSERT_TRUE(c.empty());
+}
+
+struct Visitor
+{
+	void operator()(const int& i) { ints += i; }
+	void operator()(const std::string& str) { strings += str; }
+	void operator()(const double&) { ++doubles; }
+
+	int ints = 0;
+	std::string strings;
+	int doubles = 0;
+};
+
+TEST(any, visit)
+{
+	Visitor visitor;
+
+	static_any<32> a = 7;
+	ASSERT_TRUE((visit<double, int, std::string>(a, visitor)));
+	EXPECT_EQ(7, visitor.ints);
+
+	a = std::string("foo");
+	ASSERT_TRUE((visit<double, int, std::string>(a, visitor)));
+	EXPECT_EQ("foo", visitor.strings);
+
+	const static_any<32> b = .5;
+	ASSERT_TRUE((visit<double, int>(b, visitor)));
+	EXPECT_EQ(1, visitor.doubles);
+}
+
+TEST(any, visit_mutable)
+{
+	static_any<32> a = 7;
+	ASSERT_TRUE(visit<int>(a, [](int& i) { i = 8; }));
+	EXPECT_EQ(8, a.get<int>());
+}
+
+TEST(any, visit_no_match)
+{
+	Visitor visitor;
+
+	static_any<32> a;
+	EXPECT_FALSE((visit<double, int>(a, visitor)));
+
+	a = 1.f;
+	EXPECT_FALSE((visit<double, int>(a, visitor)));
+
+	EXPECT_EQ(0, visitor.ints);
+	EXPECT_EQ(0, visitor.doubles);
+}
+
+TEST(any, visit_many_candidates)
+{
+	std::vector<static_any<32>> values = { 1, 2.0, 'c', 4L, std::string("e"), short{6}, 7u, 8.f };
+
+	for (const static_any<32>& value : values)
+	{
+		static_any_type_id_t visited = 0;
+		ASSERT_TRUE((visit<float, unsigned, short, std::string, long, char, double, int>(value, [&visited](const auto& v)
+		{
+			visited = static_any_type_id<std::decay_t<decltype(v)>>::value;
+		})));
+		ASSERT_EQ(value.type_id(), visited);
+	}
+
+	// the first of duplicate candidates is called
+	int calls = 0;
+	ASSERT_TRUE((visit<int, double, int>(values[0], [&calls](const auto&) { ++calls; })));
+	ASSERT_EQ(1, calls);
+	ASSERT_FALSE((visit<double, long>(values[0], [&calls](const auto&) { ++calls; })));
+}
+
+TEST(any, visit_across_dll)
+{
+	Visitor visitor;
+
+	const auto a = get_any_with_int(7);
+	EXPECT_TRUE((visit<double, int>(a, visitor)));
+	EXPECT_EQ(7, visitor.ints);
+}
+
+TEST(any, type_id)
+{
+	static_any<32> a;
+	ASSERT_EQ(static_any_type_id<void>::value, a.type_id());
+
+	a = 7;
+	ASSERT_EQ(static_any_type_id<int>::value, a.type_id());
+	ASSERT_NE(static_any_type_id<long>::value, a.type_id());
+
+	a = std::string("foo");
+	ASSERT_EQ(static_any_type_id<std::string>::value, a.type_id());
+}
+
+TEST(any, type_id_across_dll)
+{
+	auto a = get_any_with_int(7);
+	EXPECT_EQ(static_any_type_id<int>::value, a.type_id());
+}
+
+TEST(any, registered_type_id_across_dll)
+{
+	auto a = get_any_with_registered_message(7);
+	EXPECT_EQ(42u, a.type_id());
+	EXPECT_TRUE(a.has<registered_message>());
+	EXPECT_FALSE(a.has<int>());
+	EXPECT_EQ(7, a.get<registered_message>().i);
+}
+
 TEST(any_t, simple)
 {
 	static_any_t<16> a(7);
 	ASSERT_EQ(7, a.get<int>());
 }
 
+TEST(any_t, alignment)
+{
+	static_assert(sizeof(static_any_t<8>) == 8, "no space overhead");
+	static_assert(sizeof(static_any_t<12>) == 12, "no space overhead");
+	static_assert(static_any_t<8>::alignment() == 8, "natural alignment");
+	static_assert(static_any_t<12>::alignment() == 4, "natural alignment");
+
+	static_any_t<32, 32> a = OverAligned{{1., 2., 3., 4.}};
+	ASSERT_EQ(0u, reinterpret_cast<std::uintptr_t>(&a.get<OverAligned>()) % 32);
+	ASSERT_EQ(3., a.get<OverAligned>().d[2]);
+}
+
 class UnsafeCopy
 {
 public:
@@ -594,12 +995,21 @@ TEST(any, assignment_strong_guarantee)
 	static_any<16> a(UnsafeCopy(42));
 
 	CallCounter<0>::reset_counters();
-	EXPECT_THROW(a = 5, std::runtime_error);
+	EXPECT_THROW(a = UnsafeMove(42), std::runtime_error);
 
 	ASSERT_FALSE(a.empty());
 	EXPECT_EQ(42, a.get<UnsafeCopy>().get());
 }
 
+TEST(any, nothrow_assignment_no_backup)
+{
+	static_any<16> a(UnsafeCopy(42));
+
+	// int cannot throw: no backup of the current value is made, hence no throwing copy
+	EXPECT_NO_THROW(a = 5);
+	EXPECT_EQ(5, a.get<int>());
+}
+
 TEST(any_exception, init)
 {
 	EXPECT_THROW(static_any<16> a = UnsafeMove(42), std::runtime_error);
@@ -641,6 +1051,54 @@ TEST(any_exception, emplace)
 	EXPECT_TRUE(a.empty());
 }
 
+TEST(any_exception, emplace_basic_guarantee)
+{
+	static_any<16> a(1234);
+	EXPECT_THROW(a.emplace<UnsafeConstructor>(static_any_basic_guarantee, 42), std::runtime_error);
+	EXPECT_TRUE(a.empty());
+
+	a.assign(static_any_basic_guarantee, 2.5);
+	EXPECT_EQ(2.5, a.get<double>());
+}
+
+TEST(any_exception, emplace_strong_guarantee)
+{
+	static_any<32> a(std::string("foo"));
+	EXPECT_THROW(a.emplace<UnsafeConstructor>(static_any_strong_guarantee, 42), std::runtime_error);
+	EXPECT_EQ("foo", a.get<std::string>());
+
+	a.emplace<UnsafeConstructor>(static_any_strong_guarantee, 1);
+	EXPECT_TRUE(a.has<UnsafeConstructor>());
+
+	UnsafeCopy u(42);
+	a = 1234;
+	EXPECT_THROW(a.assign(static_any_strong_guarantee, u), std::runtime_error);
+	EXPECT_EQ(1234, a.get<int>());
+}
+
+TEST(any_exception, emplace_double_buffer_guarantee)
+{
+	CallCounter<3>::reset_counters();
+
+	static_any<32> a(CallCounter<3>{});
+	CallCounter<3>::reset_counters();
+
+	// the current value is neither copied nor moved to a backup
+	EXPECT_THROW(a.emplace<UnsafeConstructor>(static_any_double_buffer_guarantee, 42), std::runtime_error);
+	EXPECT_TRUE(a.has<CallCounter<3>>());
+	EXPECT_EQ(0, CallCounter<3>::copy_constructions);
+	EXPECT_EQ(0, CallCounter<3>::move_constructions);
+
+	a.emplace<UnsafeConstructor>(static_any_double_buffer_guarantee, 1);
+	EXPECT_TRUE(a.has<UnsafeConstructor>());
+	EXPECT_EQ(1, CallCounter<3>::destructions);
+
+	// too big to be double buffered: backup
+	a = std::string("foo");
+	EXPECT_THROW(a.emplace<UnsafeConstructor>(static_any_double_buffer_guarantee_t<0>{}, 42), std::runtime_error);
+	EXPECT_EQ("foo", a.get<std::string>());
+}
+
 #endif
 
 TEST(any_exception, copy_from_any)
@@ -679,3 +1137,350 @@ TEST(any_exception, move_from_different_any)
 }
 
 
+
+template <class T>
+struct CountingAllocator
+{
+	using value_type = T;
+
+	CountingAllocator() = default;
+
+	template <class U>
+	CountingAllocator(const CountingAllocator<U>&) {}
+
+	T* allocate(std::size_t n)
+	{
+		++allocations;
+		return static_cast<T*>(::operator new(n * sizeof(T)));
+	}
+
+	void deallocate(T* p, std::size_t)
+	{
+		++deallocations;
+		::operator delete(p);
+	}
+
+	static void reset_counters()
+	{
+		allocations = 0;
+		deallocations = 0;
+	}
+
+	static int allocations;
+	static int deallocations;
+};
+
+template <class T> int CountingAllocator<T>::allocations = 0;
+template <class T> int CountingAllocator<T>::deallocations = 0;
+
+template <class T, class U>
+bool operator==(const CountingAllocator<T>&, const CountingAllocator<U>&) { return true; }
+template <class T, class U>
+bool operator!=(const CountingAllocator<T>&, const CountingAllocator<U>&) { return false; }
+
+using SmallAny = small_any<16, CountingAllocator<char>>;
+using SmallAnyAllocator = CountingAllocator<std::max_align_t>;
+using Array64 = std::array<char, 64>;
+
+TEST(small_any, inline_value)
+{
+	SmallAnyAllocator::reset_counters();
+
+	SmallAny a = 1234;
+	ASSERT_TRUE(a.is_inline());
+	ASSERT_EQ(1234, a.get<int>());
+	ASSERT_EQ(sizeof(int), a.size());
+
+	SmallAny b = a;
+	ASSERT_EQ(1234, any_cast<int>(b));
+
+	ASSERT_EQ(0, SmallAnyAllocator::allocations);
+}
+
+TEST(small_any, heap_value)
+{
+	SmallAnyAllocator::reset_counters();
+
+	{
+		SmallAny a = Array64{{'a', 'b'}};
+		ASSERT_FALSE(a.is_inline());
+		ASSERT_EQ('b', a.get<Array64>()[1]);
+		ASSERT_EQ(64u, a.size());
+		ASSERT_EQ(1, SmallAnyAllocator::allocations);
+
+		SmallAny b = a;
+		ASSERT_EQ('a', b.get<Array64>()[0]);
+		ASSERT_EQ(2, SmallAnyAllocator::allocations);
+
+		// the allocation is stolen
+		SmallAny c = std::move(a);
+		ASSERT_TRUE(a.empty());
+		ASSERT_EQ('a', any_cast<Array64>(c)[0]);
+		ASSERT_EQ(2, SmallAnyAllocator::allocations);
+
+		c = 5;
+		ASSERT_EQ(5, c.get<int>());
+		ASSERT_EQ(1, SmallAnyAllocator::deallocations);
+	}
+
+	ASSERT_EQ(2, SmallAnyAllocator::deallocations);
+}
+
+TEST(small_any, allocator_constructor)
+{
+	CountingAllocator<char> alloc;
+	SmallAny a(alloc);
+	ASSERT_TRUE(a.empty());
+
+	std::allocator<char> std_alloc;
+	small_any<16> b(std_alloc);
+	ASSERT_TRUE(b.empty());
+
+	SmallAny c(1, alloc);
+	ASSERT_EQ(1, c.get<int>());
+}
+
+TEST(small_any, throwing_move_is_allocated)
+{
+	SmallAny a = UnsafeMove(7);
+	ASSERT_FALSE(a.is_inline());
+	ASSERT_EQ(7, a.get<UnsafeMove>().get());
+}
+
+TEST(small_any, destruction)
+{
+	CallCounter<0>::reset_counters();
+	{
+		small_any<16> a;
+		a.emplace<CallCounter<0>>();
+		small_any<16> b = a;
+	}
+
+	EXPECT_EQ(1, CallCounter<0>::constructions);
+	EXPECT_EQ(1, CallCounter<0>::copy_constructions);
+	EXPECT_EQ(2, CallCounter<0>::destructions);
+}
+
+TEST(small_any, bad_cast)
+{
+	small_any<16> a = std::string("foo");
+	EXPECT_EQ(nullptr, any_cast<int>(&a));
+	EXPECT_THROW(a.get<int>(), bad_any_cast);
+	EXPECT_EQ(typeid(std::string), a.type());
+}
+
+using RangeAny = static_any<32>;
+
+TEST(any_range, copy_destroy)
+{
+	std::vector<RangeAny> src = { 1, 2, std::string("foo"), std::string("bar"), RangeAny(), 3.0 };
+
+	std::allocator<RangeAny> alloc;
+	RangeAny* dst = alloc.allocate(src.size());
+
+	RangeAny* end = uninitialized_copy_range(src.data(), src.data() + src.size(), dst);
+	ASSERT_EQ(dst + src.size(), end);
+
+	ASSERT_EQ(2, dst[1].get<int>());
+	ASSERT_EQ("bar", dst[3].get<std::string>());
+	ASSERT_TRUE(dst[4].empty());
+	ASSERT_EQ(3.0, dst[5].get<double>());
+	ASSERT_EQ("foo", src[2].get<std::string>());
+
+	destroy_range(dst, end);
+	alloc.deallocate(dst, src.size());
+}
+
+TEST(any_range, copy_strong_guarantee)
+{
+	CallCounter<0>::reset_counters();
+	std::vector<RangeAny> src;
+	src.emplace_back(CallCounter<0>());
+	src.emplace_back(CallCounter<0>());
+	src.emplace_back(UnsafeCopy(42));
+	CallCounter<0>::reset_counters();
+
+	std::allocator<RangeAny> alloc;
+	RangeAny* dst = alloc.allocate(src.size());
+
+	ASSERT_THROW(uninitialized_copy_range(src.data(), src.data() + src.size(), dst), std::runtime_error);
+	ASSERT_EQ(2, CallCounter<0>::copy_constructions);
+	ASSERT_EQ(2, CallCounter<0>::destructions);
+
+	alloc.deallocate(dst, src.size());
+}
+
+TEST(any_range, relocate)
+{
+	NoexceptCallCounter<0>::reset_counters();
+	std::vector<RangeAny> src = { 1, NoexceptCallCounter<0>(), NoexceptCallCounter<0>(), 2.0, UnsafeMove(1) };
+	NoexceptCallCounter<0>::reset_counters();
+
+	std::allocator<RangeAny> alloc;
+	RangeAny* storage = alloc.allocate(src.size());
+	RangeAny* first = uninitialized_copy_range(src.data(), src.data() + src.size(), storage) - src.size();
+	RangeAny* dst = alloc.allocate(src.size());
+
+	RangeAny* end = uninitialized_relocate_range(first, first + src.size(), dst);
+	ASSERT_EQ(dst + src.size(), end);
+
+	ASSERT_EQ(1, dst[0].get<int>());
+	ASSERT_TRUE(dst[1].has<NoexceptCallCounter<0>>());
+	ASSERT_EQ(2.0, dst[3].get<double>());
+	ASSERT_EQ(1, dst[4].get<UnsafeMove>().get());
+
+	// copied once from src, moved once by the relocation, the moved-from values are destroyed
+	ASSERT_EQ(2, NoexceptCallCounter<0>::copy_constructions);
+	ASSERT_EQ(2, NoexceptCallCounter<0>::move_constructions);
+	ASSERT_EQ(2, NoexceptCallCounter<0>::destructions);
+
+	destroy_range(dst, end);
+	ASSERT_EQ(4, NoexceptCallCounter<0>::destructions);
+
+	alloc.deallocate(dst, src.size());
+	alloc.deallocate(storage, src.size());
+}
+
+TEST(any_range, relocate_strong_guarantee)
+{
+	std::vector<RangeAny> src = { std::string("foo"), UnsafeMove(1), RangeAny() };
+	src[2].emplace<UnsafeMove>(42);
+
+	std::allocator<RangeAny> alloc;
+	RangeAny* dst = alloc.allocate(src.size());
+
+	ASSERT_THROW(uninitialized_relocate_range(src.data(), src.data() + src.size(), dst), std::runtime_error);
+	ASSERT_EQ("foo", src[0].get<std::string>());
+	ASSERT_EQ(42, src[2].get<UnsafeMove>().get());
+
+	alloc.deallocate(dst, src.size());
+}
+
+TEST(any, equality)
+{
+	static_any<32> a = 1;
+	static_any<16> b = 1;
+
+	ASSERT_TRUE(a == b);
+	ASSERT_FALSE(a != b);
+
+	b = 2;
+	ASSERT_FALSE(a == b);
+
+	b = 1.0;
+	ASSERT_FALSE(a == b);
+
+	a = std::string("foo");
+	ASSERT_TRUE(a == static_any<32>(std::string("foo")));
+	ASSERT_TRUE(static_any<8>() == static_any<16>());
+	ASSERT_FALSE(a == static_any<32>());
+
+	ASSERT_TRUE(get_any_with_int(3) == static_any<16>(3));
+}
+
+TEST(any, ordering)
+{
+	std::vector<static_any<32>> v = { 3, std::string("b"), 1, static_any<32>(), std::string("a"), 2 };
+	std::sort(v.begin(), v.end());
+
+	// the order between int and std::string is unspecified, but values of the same type are contiguous
+	const std::size_t ints = v[1].has<int>() ? 1 : 3;
+	const std::size_t strings = v[1].has<int>() ? 4 : 1;
+
+	ASSERT_TRUE(v[0].empty());
+	ASSERT_EQ(1, v[ints].get<int>());
+	ASSERT_EQ(2, v[ints + 1].get<int>());
+	ASSERT_EQ(3, v[ints + 2].get<int>());
+	ASSERT_EQ("a", v[strings].get<std::string>());
+	ASSERT_EQ("b", v[strings + 1].get<std::string>());
+
+	ASSERT_TRUE(v[1] <= v[1] && v[1] >= v[1]);
+	ASSERT_TRUE(v[5] > v[0]);
+}
+
+TEST(any, hash)
+{
+	std::unordered_set<static_any<32>> set;
+	set.insert(1);
+	set.insert(std::string("foo"));
+	set.insert(1);
+	set.insert(1u);
+	set.insert(static_any<32>());
+
+	ASSERT_EQ(4u, set.size());
+	ASSERT_EQ(1u, set.count(std::string("foo")));
+	ASSERT_EQ(0u, set.count(2));
+	ASSERT_EQ(std::hash<static_any<32>>{}(static_any<32>(42)), static_any<32>(42).hash());
+}
+
+TEST(any, unsupported_operations)
+{
+	static_any<16> a = A(1);
+	static_any<16> b = A(1);
+
+	ASSERT_THROW(a.hash(), bad_any_operation);
+	ASSERT_THROW(a == b, bad_any_operation);
+	ASSERT_THROW(a < b, bad_any_operation);
+
+	// different types are never compared
+	ASSERT_FALSE(a == static_any<16>(1));
+}
+
+namespace {
+
+struct NoEq
+{
+	int i;
+};
+
+struct OrderId
+{
+	int i;
+
+	bool operator==(const OrderId& other) const { return i == other.i; }
+};
+
+}
+
+template <> struct static_any_comparable<OrderId> : std::true_type {};
+
+TEST(any, comparisons_opt_in)
+{
+	// std::vector and std::pair declare operator== for any type: they do not opt in, so that it is not instantiated
+	static_any<32> v = std::vector<NoEq>{};
+	static_any<32> p = std::make_pair(1, NoEq{1});
+	ASSERT_THROW(v == v, bad_any_operation);
+	ASSERT_THROW(p.hash(), bad_any_operation);
+
+	static_any<16> a = OrderId{1};
+	ASSERT_TRUE(a == static_any<16>(OrderId{1}));
+	ASSERT_FALSE(a == static_any<16>(OrderId{2}));
+
+	// opted in, but without std::hash nor operator<
+	ASSERT_THROW(a.hash(), bad_any_operation);
+	ASSERT_THROW(a < a, bad_any_operation);
+}
+
+TEST(any_t, bytewise_hash)
+{
+	static_any_t<8> a = 42;
+	static_any_t<8> b = 42;
+
+	ASSERT_TRUE(a.equals<int>(b));
+	ASSERT_EQ(a.hash<int>(), b.hash<int>());
+
+	b = 43;
+	ASSERT_FALSE(a.equals<int>(b));
+}
+
+TEST(any, assign_empty)
+{
+	static_any<16> a = 1;
+	a = static_any<16>();
+	ASSERT_TRUE(a.empty());
+
+	static_any<16> b = 1;
+	const static_any<8> empty;
+	b = empty;
+	ASSERT_TRUE(b.empty());
+}